@@ -199,6 +199,12 @@ PyAPI_FUNC(void) PyEval_ReleaseThread(PyThreadState *tstate);
 #ifndef Py_LIMITED_API
 PyAPI_FUNC(void) _PyEval_SetSwitchInterval(unsigned long microseconds);
 PyAPI_FUNC(unsigned long) _PyEval_GetSwitchInterval(void);
+PyAPI_FUNC(void) _PyEval_SetGILFifo(int enabled);
+PyAPI_FUNC(int) _PyEval_GetGILFifo(void);
+PyAPI_FUNC(void) _PyEval_SetGILStatsEnabled(int enabled);
+PyAPI_FUNC(int) _PyEval_GetGILStatsEnabled(void);
+PyAPI_FUNC(void) _PyEval_ResetGILStats(void);
+PyAPI_FUNC(PyObject *) _PyEval_GetGILStats(void);
 #endif
 
 #ifndef Py_LIMITED_API
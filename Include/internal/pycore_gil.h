@@ -21,6 +21,29 @@ extern "C" {
 #undef FORCE_SWITCHING
 #define FORCE_SWITCHING
 
+/* Number of buckets in the GIL wait and hold time histograms.  Bucket 0
+   counts durations under a microsecond and bucket i counts durations in
+   [2**(i-1), 2**i) microseconds; the last bucket also counts anything
+   longer. */
+#define _Py_GIL_HISTOGRAM_BUCKETS 32
+
+struct _gil_stats {
+    /* Time from asking for the GIL to getting it. */
+    unsigned long long wait[_Py_GIL_HISTOGRAM_BUCKETS];
+    /* Time from getting the GIL to releasing it. */
+    unsigned long long hold[_Py_GIL_HISTOGRAM_BUCKETS];
+    /* Drop requests made by a thread that timed out waiting for the GIL. */
+    unsigned long long drop_requests;
+    /* Releases of the GIL while a drop request was pending. */
+    unsigned long long forced_switches;
+};
+
+/* A thread waiting in take_gil(), queued in arrival order. */
+struct _gil_waiter {
+    struct _gil_waiter *prev;
+    struct _gil_waiter *next;
+};
+
 struct _gil_runtime_state {
     /* microseconds (the Python API uses seconds, though) */
     unsigned long interval;
@@ -43,6 +66,17 @@ struct _gil_runtime_state {
     PyCOND_T switch_cond;
     PyMUTEX_T switch_mutex;
 #endif
+    /* Threads waiting for the GIL, oldest first.  In FIFO mode only the
+       oldest waiter may take a free GIL, so a thread that drops it and asks
+       again goes to the back of the line instead of racing the others. */
+    int fifo;
+    struct _gil_waiter *waiters_head;
+    struct _gil_waiter *waiters_tail;
+    /* Whether take_gil() and drop_gil() record timings in stats.  All of
+       the fields below are protected by mutex. */
+    int collect_stats;
+    _PyTime_t acquired_at;
+    struct _gil_stats stats;
 };
 
 #ifdef __cplusplus
@@ -143,9 +143,14 @@ struct _gc_runtime_state {
        collections, and are awaiting to undergo a full collection for
        the first time. */
     Py_ssize_t long_lived_pending;
+    /* true if forked children should move every tracked object into the
+       permanent generation, so their collections never write to the GC
+       headers of objects shared with the parent. */
+    int freeze_on_fork;
 };
 
 PyAPI_FUNC(void) _PyGC_Initialize(struct _gc_runtime_state *);
+PyAPI_FUNC(void) _PyGC_AfterFork_Child(void);
 
 
 /* Set the memory allocator of the specified domain to the default.
@@ -73,6 +73,12 @@ _PyShadow_FindCache(PyObject *from)
 #define INITIAL_POLYMORPHIC_CACHE_ARRAY_SIZE 4
 #define POLYMORPHIC_CACHE_SIZE 4
 
+/* Number of entries in the global megamorphic attribute cache, which is
+ * shared by all call sites that have seen more types than fit in a
+ * polymorphic cache.  Must be a power of two. */
+#define MEGAMORPHIC_CACHE_SIZE_EXP 12
+#define MEGAMORPHIC_CACHE_SIZE (1 << MEGAMORPHIC_CACHE_SIZE_EXP)
+
 /* Gets a code cache object from the given weak-referencable object.  This
 supports getting caches from types and modules (at least).
 
@@ -126,6 +132,14 @@ typedef struct {
     int offset, type;
 } _FieldCache;
 
+/* Cache for CALL_FUNCTION_TYPE: calling a heap type that uses object.__new__
+ * and initializes its instances with a Python __init__ */
+typedef struct {
+    PyTypeObject *type;       /* borrowed, only valid while the tag matches */
+    unsigned int version_tag; /* tp_version_tag when the cache was filled */
+    PyObject *init;           /* borrowed from the type's MRO */
+} _PyShadow_TypeCallCache;
+
 /* Tracks metadata about our shadow code */
 typedef struct _PyShadowCode {
     PyObject ***globals;
@@ -140,12 +154,21 @@ typedef struct _PyShadowCode {
     _FieldCache *field_caches;
     Py_ssize_t field_cache_size;
 
+    _PyShadow_TypeCallCache *type_call_caches;
+    Py_ssize_t type_call_caches_size;
+
     Py_ssize_t update_count;
     Py_ssize_t len;
 
     PyObject ***functions;
     Py_ssize_t functions_size;
 
+    /* All live shadow code is kept in a list so that the caches of code which
+     * has gone cold can be found and freed by _PyShadow_CompactCaches */
+    struct _PyShadowCode *prev, *next;
+    PyCodeObject *owner; /* borrowed, the code object holding this cache */
+    int used;            /* executed since the last compaction */
+
     _Py_CODEUNIT code[];
 } _PyShadowCode;
 
@@ -209,6 +232,16 @@ PyObject *_PyShadow_GetInlineCacheStats(PyObject *self);
 
 PyAPI_FUNC(void) _PyShadow_ClearCache(PyObject *co);
 
+/* Non-zero if cache compaction runs on every full garbage collection */
+extern int _PyShadow_CacheCompactionEnabled;
+
+/* Returns a dict of the bytes used by shadow code and its caches, by kind */
+PyAPI_FUNC(PyObject *) _PyShadow_GetCacheMemoryStats(void);
+
+/* Frees the shadow code of every code object which hasn't run since the
+ * previous compaction, returning how many were freed */
+PyAPI_FUNC(Py_ssize_t) _PyShadow_CompactCaches(void);
+
 int _PyShadow_PatchByteCode(_PyShadow_EvalState *shadow,
                             const _Py_CODEUNIT *next_instr,
                             int op,
@@ -288,6 +321,22 @@ _PyShadow_GetFieldCache(_PyShadow_EvalState *state, int offset)
 
 int _PyShadow_CacheFieldType(_PyShadow_EvalState *state, int offset, int type);
 
+static inline _PyShadow_TypeCallCache *
+_PyShadow_GetTypeCallCache(_PyShadow_EvalState *state, int offset)
+{
+    assert(state->shadow->type_call_caches != NULL);
+    assert(offset > -1 && offset < state->shadow->type_call_caches_size);
+    return &state->shadow->type_call_caches[offset];
+}
+
+void _PyShadow_InitCallFunction(_PyShadow_EvalState *state,
+                                const _Py_CODEUNIT *next_instr,
+                                PyObject *func,
+                                int nargs);
+PyObject *_PyShadow_CallType(_PyShadow_TypeCallCache *cache,
+                             PyObject **args,
+                             Py_ssize_t nargs);
+
 PyObject *_PyShadow_LoadAttrPolymorphic(_PyShadow_EvalState *shadow,
                                         const _Py_CODEUNIT *next_instr,
                                         _PyShadow_InstanceAttrEntry **entries,
@@ -322,6 +371,22 @@ int _PyShadow_LoadMethodInvalidate(_PyShadow_EvalState *shadow,
                                    PyObject *type,
                                    PyObject **meth);
 
+/* Loads an attribute through the global megamorphic cache, which is keyed by
+ * the owner's type version tag and the attribute name. */
+PyObject *_PyShadow_LoadAttrMegamorphic(_PyShadow_EvalState *shadow,
+                                        const _Py_CODEUNIT *next_instr,
+                                        PyObject *owner,
+                                        PyObject *name);
+
+int _PyShadow_LoadMethodMegamorphic(_PyShadow_EvalState *shadow,
+                                    const _Py_CODEUNIT *next_instr,
+                                    PyObject *obj,
+                                    PyObject *name,
+                                    PyObject **meth);
+
+/* Drops all entries from the megamorphic cache. */
+void _PyShadow_ClearMegamorphicCache(void);
+
 PyObject *_PyShadow_LoadAttrWithCache(_PyShadow_EvalState *shadow,
                                      const _Py_CODEUNIT *next_instr,
                                      PyObject *owner,
@@ -352,6 +417,13 @@ PyObject *_PyShadow_BinarySubscrWithCache(_PyShadow_EvalState *shadow,
                                           PyObject *sub,
                                           int oparg);
 
+/* Handles a type miss in BINARY_ADD_INT/BINARY_ADD_FLOAT: restores the
+ * BINARY_ADD or INPLACE_ADD the site was quickened from and performs it */
+PyObject *_PyShadow_BinaryAddMiss(_PyShadow_EvalState *shadow,
+                                  const _Py_CODEUNIT *next_instr,
+                                  PyObject *left,
+                                  PyObject *right);
+
 Py_ssize_t _Py_NO_INLINE _PyShadow_FixDictOffset(PyObject *obj,
                                                  Py_ssize_t dictoffset);
 
@@ -1450,6 +1522,113 @@ _PyShadow_StoreAttrSplitDictMethod(_PyShadow_EvalState *shadow,
     return 0;
 }
 
+/* list[int] for BINARY_SUBSCR_LIST_INT, sub must be an exact int */
+static inline PyObject *
+_PyShadow_ListSubscrInt(PyObject *list, PyObject *sub)
+{
+    Py_ssize_t i = PyLong_AsSsize_t(sub);
+    if (i == -1 && PyErr_Occurred()) {
+        /* Let the generic path report the overflow */
+        PyErr_Clear();
+        return _PyList_Subscript(list, sub);
+    }
+    if (i < 0) {
+        i += PyList_GET_SIZE(list);
+    }
+    if ((size_t)i >= (size_t)PyList_GET_SIZE(list)) {
+        PyErr_SetString(PyExc_IndexError, "list index out of range");
+        return NULL;
+    }
+    PyObject *res = PyList_GET_ITEM(list, i);
+    Py_INCREF(res);
+    return res;
+}
+
+/* list[int] = v for STORE_SUBSCR_LIST_INT, sub must be an exact int */
+static inline int
+_PyShadow_ListAssSubscrInt(PyObject *list, PyObject *sub, PyObject *v)
+{
+    Py_ssize_t i = PyLong_AsSsize_t(sub);
+    if (i == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return PyObject_SetItem(list, sub, v);
+    }
+    if (i < 0) {
+        i += PyList_GET_SIZE(list);
+    }
+    if ((size_t)i >= (size_t)PyList_GET_SIZE(list)) {
+        PyErr_SetString(PyExc_IndexError, "list assignment index out of range");
+        return -1;
+    }
+    PyObject *old_value = PyList_GET_ITEM(list, i);
+    Py_INCREF(v);
+    PyList_SET_ITEM(list, i, v);
+    Py_DECREF(old_value);
+    return 0;
+}
+
+/* True if func is a plain Python function which can be called with nargs
+ * positional arguments by pushing its frame directly */
+static inline int
+_PyShadow_IsFastCallFunction(PyObject *func, Py_ssize_t nargs)
+{
+    if (!PyFunction_Check(func) ||
+        ((PyFunctionObject *)func)->vectorcall != _PyFunction_Vectorcall) {
+        return 0;
+    }
+    /* Defaults can be ignored, all positional arguments are passed */
+    PyCodeObject *co = (PyCodeObject *)PyFunction_GET_CODE(func);
+    return co->co_argcount == nargs && co->co_kwonlyargcount == 0 &&
+           (co->co_flags & ~PyCF_MASK) ==
+               (CO_OPTIMIZED | CO_NEWLOCALS | CO_NOFREE);
+}
+
+static inline PyObject *
+_PyShadow_FastCallFunction(PyObject *func, PyObject **args, Py_ssize_t nargs)
+{
+    PyFunctionObject *f = (PyFunctionObject *)func;
+    return _PyFunctionCode_FastCall((PyCodeObject *)f->func_code,
+                                    args,
+                                    nargs,
+                                    f->func_globals,
+                                    f->func_name,
+                                    f->func_qualname);
+}
+
+/* True if func is a builtin function taking nargs positional arguments via
+ * METH_FASTCALL or METH_O */
+static inline int
+_PyShadow_IsFastCallCFunction(PyObject *func, Py_ssize_t nargs)
+{
+    if (!PyCFunction_Check(func)) {
+        return 0;
+    }
+    int flags = PyCFunction_GET_FLAGS(func) &
+                ~(METH_CLASS | METH_STATIC | METH_COEXIST);
+    return flags == METH_FASTCALL || (flags == METH_O && nargs == 1);
+}
+
+static inline PyObject *
+_PyShadow_FastCallCFunction(PyThreadState *tstate,
+                            PyObject *func,
+                            PyObject **args,
+                            Py_ssize_t nargs)
+{
+    if (Py_EnterRecursiveCall(" while calling a Python object")) {
+        return NULL;
+    }
+    PyObject *self = PyCFunction_GET_SELF(func);
+    PyObject *res;
+    if (PyCFunction_GET_FLAGS(func) & METH_O) {
+        res = PyCFunction_GET_FUNCTION(func)(self, args[0]);
+    } else {
+        res = ((_PyCFunctionFast)(void (*)(void))PyCFunction_GET_FUNCTION(
+            func))(self, args, nargs);
+    }
+    Py_LeaveRecursiveCall();
+    return _Py_CheckFunctionResult(tstate, func, res, NULL);
+}
+
 static inline int
 _PyShadow_StoreAttrSlot(_PyShadow_EvalState *shadow,
                         const _Py_CODEUNIT *next_instr,
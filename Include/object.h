@@ -876,6 +876,11 @@ PyAPI_FUNC(int) _PyType_InitSwitchboard(void);
 /* Returns a borrowed reference */
 PyAPI_FUNC(PyObject *) _PyType_GetSwitchboard(void);
 PyAPI_FUNC(void) _PyType_ClearSwitchboard(void);
+
+/* Ensure type has a valid tp_version_tag.  Returns 1 on success, or 0 if the
+   type can't be given one, in which case tp_version_tag is 0.  Tags are never
+   reused, and a type's tag is reset to 0 whenever the type is modified. */
+PyAPI_FUNC(int) _PyType_AssignVersionTag(PyTypeObject *type);
 #endif
 
 #ifdef __cplusplus
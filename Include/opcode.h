@@ -160,6 +160,16 @@ extern "C" {
 #define RETURN_INT              197
 #define LOAD_METHOD_SUPER       198
 #define LOAD_ATTR_SUPER         199
+#define LOAD_ATTR_MEGAMORPHIC   200
+#define LOAD_METHOD_MEGAMORPHIC 201
+#define BINARY_ADD_INT          202
+#define BINARY_ADD_FLOAT        203
+#define COMPARE_OP_INT          204
+#define BINARY_SUBSCR_LIST_INT  205
+#define STORE_SUBSCR_LIST_INT   206
+#define CALL_FUNCTION_PYFUNC    207
+#define CALL_FUNCTION_CFUNC     208
+#define CALL_FUNCTION_TYPE      209
 #define LOAD_ATTR_S_MODULE      211
 #define LOAD_METHOD_S_MODULE    212
 #define INVOKE_FUNCTION_CACHED  213
@@ -19,79 +19,7 @@ namespace autogen {
 
 #define ANY "*"
 
-namespace {
-// Add a pattern to an existing trie tree. If the trie tree is nullptr, create a
-// new one.
-std::unique_ptr<PatternNode> addPattern(
-    std::unique_ptr<PatternNode> patterns,
-    const std::string& s,
-    PatternNode::func_t func) {
-  JIT_DCHECK(!s.empty(), "pattern string should not be empty.");
-
-  if (patterns == nullptr) {
-    patterns = std::make_unique<PatternNode>();
-  }
-
-  PatternNode* cur = patterns.get();
-  for (auto& c : s) {
-    auto iter = cur->next.find(c);
-    if (iter == cur->next.end()) {
-      cur = cur->next.emplace(c, std::make_unique<PatternNode>())
-                .first->second.get();
-      continue;
-    }
-    cur = iter->second.get();
-  }
-
-  JIT_DCHECK(cur->func == nullptr, "Found duplicated pattern.");
-  cur->func = func;
-
-  return patterns;
-}
-
-// Find the function associated to the pattern given in s.
-PatternNode::func_t findByPattern(
-    const PatternNode* patterns,
-    const std::string& s) {
-  auto cur = patterns;
-  for (auto& c : s) {
-    auto iter = cur->next.find(c);
-    if (iter != cur->next.end()) {
-      cur = iter->second.get();
-      continue;
-    }
-
-    iter = cur->next.find('?');
-    if (iter != cur->next.end()) {
-      cur = iter->second.get();
-      continue;
-    }
-
-    iter = cur->next.find('*');
-    if (iter != cur->next.end()) {
-      cur = iter->second.get();
-      break;
-    }
-
-    return nullptr;
-  }
-
-  return cur->func;
-}
-
-} // namespace
-
-// this function generates operand patterns from the inputs and outputs
-// of a given instruction instr and calls the correspoinding code generation
-// functions.
-void AutoTranslator::translateInstr(Environ* env, const Instruction* instr)
-    const {
-  auto opcode = instr->opcode();
-  if (opcode == Instruction::kBind) {
-    return;
-  }
-  auto& instr_map = map_get(instr_rule_map_, opcode);
-
+std::string getOperandPattern(const Instruction* instr) {
   std::string pattern;
   pattern.reserve(instr->getNumInputs() + instr->getNumOutputs());
 
@@ -135,6 +63,21 @@ void AutoTranslator::translateInstr(Environ* env, const Instruction* instr)
     }
   });
 
+  return pattern;
+}
+
+// this function generates operand patterns from the inputs and outputs
+// of a given instruction instr and calls the correspoinding code generation
+// functions.
+void AutoTranslator::translateInstr(Environ* env, const Instruction* instr)
+    const {
+  auto opcode = instr->opcode();
+  if (opcode == Instruction::kBind) {
+    return;
+  }
+  auto& instr_map = map_get(instr_rule_map_, opcode);
+
+  auto pattern = getOperandPattern(instr);
   auto func = findByPattern(instr_map.get(), pattern);
   JIT_CHECK(
       func != nullptr,
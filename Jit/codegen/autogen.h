@@ -7,6 +7,7 @@
 #include "Jit/util.h"
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace jit {
@@ -15,13 +16,83 @@ namespace autogen {
 
 // this struct defines a trie tree node to support instruction
 // operand type matching.
-struct PatternNode {
-  using func_t = void (*)(Environ*, const jit::lir::Instruction*);
+template <typename Func>
+struct BasicPatternNode {
+  using func_t = Func;
 
-  std::unordered_map<char, std::unique_ptr<PatternNode>> next;
+  std::unordered_map<char, std::unique_ptr<BasicPatternNode>> next;
   func_t func{nullptr};
 };
 
+using PatternNode =
+    BasicPatternNode<void (*)(Environ*, const jit::lir::Instruction*)>;
+
+// Add a pattern to an existing trie tree. If the trie tree is nullptr, create a
+// new one.
+template <typename Func>
+std::unique_ptr<BasicPatternNode<Func>> addPattern(
+    std::unique_ptr<BasicPatternNode<Func>> patterns,
+    const std::string& s,
+    typename BasicPatternNode<Func>::func_t func) {
+  JIT_DCHECK(!s.empty(), "pattern string should not be empty.");
+
+  if (patterns == nullptr) {
+    patterns = std::make_unique<BasicPatternNode<Func>>();
+  }
+
+  auto cur = patterns.get();
+  for (auto& c : s) {
+    auto iter = cur->next.find(c);
+    if (iter == cur->next.end()) {
+      cur = cur->next.emplace(c, std::make_unique<BasicPatternNode<Func>>())
+                .first->second.get();
+      continue;
+    }
+    cur = iter->second.get();
+  }
+
+  JIT_DCHECK(cur->func == nullptr, "Found duplicated pattern.");
+  cur->func = func;
+
+  return patterns;
+}
+
+// Find the function associated to the pattern given in s.
+template <typename Func>
+Func findByPattern(
+    const BasicPatternNode<Func>* patterns,
+    const std::string& s) {
+  auto cur = patterns;
+  for (auto& c : s) {
+    auto iter = cur->next.find(c);
+    if (iter != cur->next.end()) {
+      cur = iter->second.get();
+      continue;
+    }
+
+    iter = cur->next.find('?');
+    if (iter != cur->next.end()) {
+      cur = iter->second.get();
+      continue;
+    }
+
+    iter = cur->next.find('*');
+    if (iter != cur->next.end()) {
+      cur = iter->second.get();
+      break;
+    }
+
+    return nullptr;
+  }
+
+  return cur->func;
+}
+
+// Build the operand pattern string of an instruction, e.g. "Rri" for an
+// instruction with a register output and register and immediate inputs.
+// See the rule table in autogen.cpp for the meaning of each character.
+std::string getOperandPattern(const jit::lir::Instruction* instr);
+
 // A machine code generator from LIR.
 // This class generates machine code based on a set of user-defined rules.
 // See autogen.cpp file for details.
@@ -763,17 +763,14 @@ void NativeGenerator::generateDeoptExits() {
   std::sort(deopt_exits.begin(), deopt_exits.end(), [](auto& a, auto& b) {
     return a.deopt_meta_index < b.deopt_meta_index;
   });
-  // Generate stage 1 trampolines (one per guard). These push the index of the
-  // appropriate `DeoptMetadata` and then jump to the stage 2 trampoline.
-  for (const auto& exit : deopt_exits) {
-    as_->bind(exit.label);
-    as_->push(exit.deopt_meta_index);
-    as_->jmp(deopt_exit);
-  }
   // Generate the stage 2 trampoline (one per function). This saves the address
   // of the final part of the JIT-epilogue that is responsible for restoring
   // callee-saved registers and returning, our scratch register (since we need
   // it), and jumps to the final trampoline.
+  //
+  // It is emitted before the stage 1 trampolines so that they jump backwards
+  // to a bound label, which lets the assembler use the 2-byte short form of
+  // jmp instead of the 5-byte near form.
   as_->bind(deopt_exit);
   as_->push(deopt_scratch_reg);
   as_->push(deopt_scratch_reg);
@@ -784,6 +781,25 @@ void NativeGenerator::generateDeoptExits() {
       : deopt_trampoline_;
   as_->mov(deopt_scratch_reg, reinterpret_cast<uint64_t>(trampoline));
   as_->jmp(deopt_scratch_reg);
+
+  // Generate stage 1 trampolines (one per guard). These push the index of the
+  // appropriate `DeoptMetadata` and then jump to the stage 2 trampoline. Each
+  // one is at most 7 bytes (push imm32 + short jmp), so every
+  // kDeoptExitsPerRelay of them we emit a relay jump to the stage 2 trampoline
+  // that keeps the following ones within the range of a short jmp.
+  constexpr size_t kDeoptExitsPerRelay = 12;
+  auto target = deopt_exit;
+  for (size_t i = 0; i < deopt_exits.size(); i++) {
+    if (i > 0 && i % kDeoptExitsPerRelay == 0) {
+      target = as_->newLabel();
+      as_->bind(target);
+      as_->jmp(deopt_exit);
+    }
+    const auto& exit = deopt_exits[i];
+    as_->bind(exit.label);
+    as_->push(exit.deopt_meta_index);
+    as_->jmp(target);
+  }
   env_.addAnnotation("Deoptimization exits", deopt_cursor);
 }
 
@@ -0,0 +1,477 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include "Jit/codegen/peephole.h"
+
+#include "Jit/codegen/autogen.h"
+#include "Jit/codegen/x86_64.h"
+#include "Jit/lir/instruction.h"
+#include "Jit/lir/operand.h"
+#include "Jit/util.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace jit::lir;
+
+namespace jit::codegen {
+
+namespace {
+
+using instr_iter_t = Rewrite::instr_iter_t;
+using RewriteResult = Rewrite::RewriteResult;
+
+// Give up on flag liveness after visiting this many basic blocks.
+constexpr size_t kMaxFlagSearchBlocks = 8;
+
+enum class FlagUse {
+  kNone, // neither reads nor writes the flags
+  kRead, // may read the flags, or only updates some of them
+  kWrite, // overwrites the flags without reading them
+};
+
+FlagUse getFlagUse(const Instruction* instr) {
+  if (instr->isBranchCC() || instr->isCondBranch() || instr->isJz() ||
+      instr->isJnz()) {
+    return FlagUse::kRead;
+  }
+
+  switch (instr->opcode()) {
+    case Instruction::kInc:
+    case Instruction::kDec:
+    case Instruction::kLShift:
+    case Instruction::kRShift:
+    case Instruction::kRShiftUn:
+      return FlagUse::kRead;
+    case Instruction::kNegate:
+      // negating an immediate is translated into a move
+      return instr->getInput(0)->isImm() ? FlagUse::kNone : FlagUse::kWrite;
+    default:
+      break;
+  }
+
+  return InstrProperty::getProperties(instr).flag_effects == FlagEffects::kNone
+      ? FlagUse::kNone
+      : FlagUse::kWrite;
+}
+
+bool flagsLiveAfter(instr_iter_t instr_iter) {
+  std::vector<const Instruction*> readers;
+  auto block = instr_iter->get()->basicblock();
+  return !Peephole::collectFlagReaders(block, std::next(instr_iter), readers) ||
+      !readers.empty();
+}
+
+bool isQuadword(const OperandBase* operand) {
+  return !operand->isFp() && operand->sizeInBits() == 64;
+}
+
+// Return the register written by an in-place arithmetic instruction (one
+// without an output) or by its output, or REG_INVALID if there is none.
+PhyLocation getDestRegister(const Instruction* instr) {
+  auto out = instr->output();
+  if (out->isReg()) {
+    return out->getPhyRegister();
+  }
+  if (out->isNone() && instr->getNumInputs() > 0 &&
+      instr->getInput(0)->isReg()) {
+    return instr->getInput(0)->getPhyRegister();
+  }
+  return PhyLocation::REG_INVALID;
+}
+
+// Return the data type of the value produced by an arithmetic instruction.
+OperandBase::DataType getDestDataType(const Instruction* instr) {
+  auto out = instr->output();
+  return out->isNone() ? instr->getInput(0)->dataType() : out->dataType();
+}
+
+// Return the operand written by instr, or nullptr if it writes nothing.
+// Sets known to false if instr may write locations other than that operand.
+const OperandBase* getWrittenOperand(const Instruction* instr, bool& known) {
+  known = true;
+  if (instr->isCompare()) {
+    return instr->output();
+  }
+
+  switch (instr->opcode()) {
+    case Instruction::kMove:
+    case Instruction::kLea:
+    case Instruction::kMovZX:
+    case Instruction::kMovSX:
+    case Instruction::kMovSXD:
+    case Instruction::kNegate:
+    case Instruction::kInvert:
+    case Instruction::kPop:
+      return instr->output();
+    case Instruction::kMul:
+      // 8-bit multiplications implicitly write AX
+      if (instr->getInput(0)->dataType() == OperandBase::k8bit) {
+        break;
+      }
+      [[fallthrough]];
+    case Instruction::kAdd:
+    case Instruction::kSub:
+    case Instruction::kAnd:
+    case Instruction::kOr:
+    case Instruction::kXor:
+      return instr->output()->isNone() ? instr->getInput(0) : instr->output();
+    case Instruction::kInc:
+    case Instruction::kDec:
+      return instr->getInput(0);
+    case Instruction::kNop:
+    case Instruction::kPush:
+    case Instruction::kTest:
+    case Instruction::kCmp:
+    case Instruction::kBitTest:
+    case Instruction::kGuard:
+    case Instruction::kBranch:
+      return nullptr;
+    default:
+      if (instr->isBranchCC()) {
+        return nullptr;
+      }
+      break;
+  }
+
+  known = false;
+  return nullptr;
+}
+
+// Rewrite
+//   Out = Add In0, Imm    =>  Out = Lea [In0 + Imm]
+//   Out = Sub In0, Imm    =>  Out = Lea [In0 - Imm]
+//   Out = Add In0, In1    =>  Out = Lea [In0 + In1]
+// to save the extra move emitted for the three-operand forms, when the flags
+// set by the arithmetic instruction are never read.
+template <bool kNegateImm>
+RewriteResult rewriteArithmeticToLea(instr_iter_t instr_iter) {
+  auto instr = instr_iter->get();
+  auto out = instr->output();
+  auto in0 = instr->getInput(0);
+  auto in1 = instr->getInput(1);
+
+  if (!isQuadword(out) || !isQuadword(in0) ||
+      (in1->isReg() && !isQuadword(in1))) {
+    return Rewrite::kUnchanged;
+  }
+
+  PhyLocation base = in0->getPhyRegister();
+  PhyLocation index = PhyLocation::REG_INVALID;
+  int64_t offset = 0;
+
+  if (in1->isImm()) {
+    uint64_t imm = in1->getConstant();
+    offset = static_cast<int64_t>(kNegateImm ? -imm : imm);
+    if (!fitsInt32(offset)) {
+      return Rewrite::kUnchanged;
+    }
+  } else {
+    index = in1->getPhyRegister();
+    if (index == PhyLocation::RSP) {
+      // RSP cannot be used as an index register
+      if (base == PhyLocation::RSP) {
+        return Rewrite::kUnchanged;
+      }
+      std::swap(base, index);
+    }
+  }
+
+  if (flagsLiveAfter(instr_iter)) {
+    return Rewrite::kUnchanged;
+  }
+
+  instr->setOpcode(Instruction::kLea);
+  instr->setNumInputs(0);
+  instr->allocateMemoryIndirectInput(
+      base, index, 0, static_cast<int32_t>(offset));
+  return Rewrite::kChanged;
+}
+
+// Remove a Test or Cmp whose flags are never read, or a Test of a register
+// against itself when the flags it would set are already set by the
+// instruction that computed the register.
+RewriteResult removeRedundantCompare(instr_iter_t instr_iter) {
+  auto instr = instr_iter->get();
+  auto block = instr->basicblock();
+
+  std::vector<const Instruction*> readers;
+  if (!Peephole::collectFlagReaders(block, std::next(instr_iter), readers)) {
+    return Rewrite::kUnchanged;
+  }
+
+  if (readers.empty()) {
+    block->removeInstr(instr_iter);
+    return Rewrite::kRemoved;
+  }
+
+  if (!instr->isTest()) {
+    return Rewrite::kUnchanged;
+  }
+
+  auto in0 = instr->getInput(0);
+  auto in1 = instr->getInput(1);
+  if (in0->getPhyRegister() != in1->getPhyRegister() ||
+      in0->dataType() != in1->dataType()) {
+    return Rewrite::kUnchanged;
+  }
+  PhyLocation reg = in0->getPhyRegister();
+
+  // find the instruction that last set the flags, skipping over moves that do
+  // not write the tested register.
+  auto iter = instr_iter;
+  const Instruction* setter = nullptr;
+  while (iter != block->instructions().begin()) {
+    --iter;
+    auto prev = iter->get();
+    if (getFlagUse(prev) != FlagUse::kNone) {
+      setter = prev;
+      break;
+    }
+    if (!prev->isMove() || prev->output()->isNone() ||
+        (prev->output()->isReg() && prev->output()->getPhyRegister() == reg)) {
+      return Rewrite::kUnchanged;
+    }
+  }
+
+  if (setter == nullptr || getDestRegister(setter) != reg ||
+      getDestDataType(setter) != in0->dataType()) {
+    return Rewrite::kUnchanged;
+  }
+
+  switch (setter->opcode()) {
+    case Instruction::kAnd:
+    case Instruction::kOr:
+    case Instruction::kXor:
+      // these set ZF, SF and PF from the result and clear CF and OF, exactly
+      // like Test.
+      break;
+    case Instruction::kAdd:
+    case Instruction::kSub:
+      // these set ZF from the result, but CF and OF differ from Test.
+      for (auto reader : readers) {
+        if (!reader->isBranchZ() && !reader->isBranchNZ()) {
+          return Rewrite::kUnchanged;
+        }
+      }
+      break;
+    default:
+      return Rewrite::kUnchanged;
+  }
+
+  block->removeInstr(instr_iter);
+  return Rewrite::kRemoved;
+}
+
+using rule_t = RewriteResult (*)(instr_iter_t);
+using RuleNode = autogen::BasicPatternNode<rule_t>;
+
+class PeepholeRules {
+ public:
+  static PeepholeRules& getInstance() {
+    static PeepholeRules rules;
+    return rules;
+  }
+
+  rule_t findRule(const Instruction* instr) const {
+    auto iter = rules_.find(instr->opcode());
+    if (iter == rules_.end()) {
+      return nullptr;
+    }
+    return autogen::findByPattern(
+        iter->second.get(), autogen::getOperandPattern(instr));
+  }
+
+ private:
+  PeepholeRules() {
+    initTable();
+  }
+
+  void initTable();
+
+  std::unordered_map<Instruction::Opcode, std::unique_ptr<RuleNode>> rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(PeepholeRules);
+};
+
+#define BEGIN_RULES(__t) \
+  {                      \
+    auto& __rules = rules_[__t];
+
+#define END_RULES }
+
+#define RULE(s, func) __rules = autogen::addPattern(std::move(__rules), s, func);
+
+// ***********************************************************************
+// Definition of the peephole rule table
+// Rules for the same LIR instruction are grouped by BEGIN_RULES(LIR
+// instruction type) and END_RULES. RULE maps an operand pattern to the
+// function that rewrites matching instructions:
+//   RULE(<operand pattern>, <rewrite function>)
+// The operand patterns use the same notation as the autogen rule table (see
+// autogen.cpp). Rewrite functions return kUnchanged when the instruction does
+// not qualify for the rewrite.
+// ***********************************************************************
+
+// clang-format off
+void PeepholeRules::initTable() {
+BEGIN_RULES(Instruction::kAdd)
+  RULE("Rri", rewriteArithmeticToLea<false>)
+  RULE("Rrr", rewriteArithmeticToLea<false>)
+END_RULES
+
+BEGIN_RULES(Instruction::kSub)
+  RULE("Rri", rewriteArithmeticToLea<true>)
+END_RULES
+
+BEGIN_RULES(Instruction::kTest)
+  RULE("rr", removeRedundantCompare)
+END_RULES
+
+BEGIN_RULES(Instruction::kCmp)
+  RULE("rr", removeRedundantCompare)
+  RULE("ri", removeRedundantCompare)
+END_RULES
+
+BEGIN_RULES(Instruction::kBitTest)
+  RULE("ri", removeRedundantCompare)
+END_RULES
+}
+// clang-format on
+
+#undef BEGIN_RULES
+#undef END_RULES
+#undef RULE
+
+} // namespace
+
+Rewrite::RewriteResult Peephole::rewriteInstr(instr_iter_t instr_iter) {
+  auto rule = PeepholeRules::getInstance().findRule(instr_iter->get());
+  return rule == nullptr ? Rewrite::kUnchanged : rule(instr_iter);
+}
+
+bool Peephole::collectFlagReaders(
+    BasicBlock* block,
+    instr_iter_t instr_iter,
+    std::vector<const Instruction*>& readers) {
+  std::unordered_set<const BasicBlock*> visited{block};
+  std::vector<std::pair<BasicBlock*, instr_iter_t>> worklist{
+      {block, instr_iter}};
+
+  while (!worklist.empty()) {
+    auto [bb, iter] = worklist.back();
+    worklist.pop_back();
+
+    bool killed = false;
+    for (; iter != bb->instructions().end(); ++iter) {
+      auto instr = iter->get();
+      auto use = getFlagUse(instr);
+      if (use == FlagUse::kRead) {
+        readers.push_back(instr);
+      } else if (use == FlagUse::kWrite) {
+        killed = true;
+        break;
+      }
+    }
+
+    if (killed) {
+      continue;
+    }
+
+    for (auto succ : bb->successors()) {
+      if (!visited.insert(succ).second) {
+        continue;
+      }
+      if (visited.size() > kMaxFlagSearchBlocks) {
+        return false;
+      }
+      worklist.emplace_back(succ, succ->instructions().begin());
+    }
+  }
+
+  return true;
+}
+
+Rewrite::RewriteResult Peephole::forwardStackSlots(BasicBlock* block) {
+  struct SlotValue {
+    PhyLocation reg;
+    OperandBase::DataType type;
+  };
+
+  // stack slot -> register known to hold the same value
+  std::unordered_map<int, SlotValue> slots;
+
+  auto invalidateRegister = [&](PhyLocation reg) {
+    for (auto iter = slots.begin(); iter != slots.end();) {
+      if (iter->second.reg == reg) {
+        iter = slots.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  };
+
+  auto findSlot = [&](const OperandBase* operand) -> const SlotValue* {
+    auto iter = slots.find(operand->getStackSlot());
+    if (iter == slots.end() || iter->second.type != operand->dataType()) {
+      return nullptr;
+    }
+    return &iter->second;
+  };
+
+  auto changed = Rewrite::kUnchanged;
+  auto& instrs = block->instructions();
+  for (auto iter = instrs.begin(); iter != instrs.end();) {
+    auto instr = iter->get();
+
+    if (instr->isMove()) {
+      auto out = instr->output();
+      auto in = instr->getInput(0);
+
+      if (out->isReg() && in->isStack()) {
+        if (auto value = findSlot(in)) {
+          changed = Rewrite::kChanged;
+          if (value->reg == out->getPhyRegister()) {
+            // the register already holds the value of the slot
+            iter = instrs.erase(iter);
+            continue;
+          }
+          static_cast<Operand*>(in)->setPhyRegister(value->reg);
+        }
+      } else if (out->isStack() && in->isReg()) {
+        auto value = findSlot(out);
+        if (value != nullptr && value->reg == in->getPhyRegister()) {
+          // the slot already holds the value of the register
+          changed = Rewrite::kChanged;
+          iter = instrs.erase(iter);
+          continue;
+        }
+      }
+    }
+
+    bool known = false;
+    auto written = getWrittenOperand(instr, known);
+    if (!known || (written != nullptr && !written->isReg() &&
+                   !written->isStack() && !written->isNone())) {
+      slots.clear();
+    } else if (written != nullptr && written->isReg()) {
+      invalidateRegister(written->getPhyRegister());
+    } else if (written != nullptr && written->isStack()) {
+      slots.erase(written->getStackSlot());
+    }
+
+    if (instr->isMove()) {
+      auto out = instr->output();
+      auto in = instr->getInput(0);
+      if (out->isStack() && in->isReg()) {
+        slots[out->getStackSlot()] = {in->getPhyRegister(), out->dataType()};
+      } else if (out->isReg() && in->isStack()) {
+        slots[in->getStackSlot()] = {out->getPhyRegister(), in->dataType()};
+      }
+    }
+
+    ++iter;
+  }
+
+  return changed;
+}
+
+} // namespace jit::codegen
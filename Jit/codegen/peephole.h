@@ -0,0 +1,38 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#pragma once
+
+#include "Jit/codegen/rewrite.h"
+#include "Jit/lir/block.h"
+
+#include <vector>
+
+namespace jit::codegen {
+
+// Peephole optimizations over register-allocated LIR.
+//
+// Instruction-level rewrites are declared in a rule table in peephole.cpp,
+// keyed by opcode and by operand pattern in the same notation as the autogen
+// rule table. Basic block level rewrites that need to track state across
+// instructions are implemented as regular block rewrites.
+class Peephole {
+ public:
+  // Apply the rule matching the opcode and operand pattern of the
+  // instruction, if there is one.
+  static Rewrite::RewriteResult rewriteInstr(Rewrite::instr_iter_t instr_iter);
+
+  // Within a basic block, replace reloads of a stack slot with the register
+  // the slot was last stored from or loaded to, and remove stores of a value
+  // that the slot already holds.
+  static Rewrite::RewriteResult forwardStackSlots(lir::BasicBlock* block);
+
+  // Collect the instructions that may read the flags as they are right before
+  // instr_iter, following successors when the flags are live out of the
+  // block. Returns false if the readers could not be determined, in which
+  // case the flags must be considered live.
+  static bool collectFlagReaders(
+      lir::BasicBlock* block,
+      Rewrite::instr_iter_t instr_iter,
+      std::vector<const lir::Instruction*>& readers);
+};
+
+} // namespace jit::codegen
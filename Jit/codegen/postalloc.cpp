@@ -1,5 +1,6 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "Jit/codegen/postalloc.h"
+#include "Jit/codegen/peephole.h"
 #include <optional>
 
 using namespace jit::lir;
@@ -19,6 +20,9 @@ void PostRegAllocRewrite::registerRewrites() {
   registerOneRewriteFunction(optimizeMoveSequence, 1);
   registerOneRewriteFunction(optimizeMoveInstrs, 1);
   registerOneRewriteFunction(rewriteDivide);
+
+  registerOneRewriteFunction(Peephole::forwardStackSlots, 2);
+  registerOneRewriteFunction(Peephole::rewriteInstr, 2);
 }
 
 Rewrite::RewriteResult PostRegAllocRewrite::removePhiInstructions(
@@ -281,6 +281,20 @@ static DeoptReason getDeoptReason(const jit::hir::DeoptBase& instr) {
   }
 }
 
+// Returns true if instr produces the callable for a CALL_METHOD: either a
+// LoadMethod, or the guard on a module attribute cache load that replaced one.
+static bool isLoadMethodResult(const jit::hir::Instr* instr) {
+  if (instr->IsLoadMethod()) {
+    return true;
+  }
+  if (!instr->IsGuardIs()) {
+    return false;
+  }
+  auto src = instr->GetOperand(0)->instr();
+  return src->IsLoadModuleAttrCached() &&
+      static_cast<const jit::hir::LoadModuleAttrCached*>(src)->isMethod();
+}
+
 DeoptMetadata DeoptMetadata::fromInstr(
     const jit::hir::DeoptBase& instr,
     const std::unordered_set<const jit::hir::Instr*>& optimizable_lms,
@@ -288,7 +302,7 @@ DeoptMetadata DeoptMetadata::fromInstr(
   auto get_source = [&](jit::hir::Register* reg) {
     reg = hir::modelReg(reg);
     auto instr = reg->instr();
-    if (instr->IsLoadMethod()) {
+    if (isLoadMethodResult(instr)) {
       if (optimizable_lms.count(instr)) {
         return LiveValue::Source::kOptimizableLoadMethod;
       } else {
@@ -342,7 +356,7 @@ DeoptMetadata DeoptMetadata::fromInstr(
   // Translate stack
   std::unordered_set<jit::hir::Register*> lms_on_stack;
   for (auto& reg : fs->stack) {
-    if (reg->instr()->IsLoadMethod()) {
+    if (isLoadMethodResult(reg->instr())) {
       // Our logic for reconstructing the Python stack assumes that if a value
       // on the stack was produced by a LoadMethod instruction, it corresponds
       // to the output of a LOAD_METHOD opcode and will eventually be consumed
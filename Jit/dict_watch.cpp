@@ -2,22 +2,114 @@
 #include "Jit/dict_watch.h"
 
 #include "Jit/codegen/gen_asm.h"
+#include "Jit/containers.h"
 #include "Jit/inline_cache.h"
 #include "Jit/pyjit.h"
 
-#include <set>
-#include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 namespace jit {
 
 namespace {
 
-// For every watched dict, this map contains a map from keys to sets of caches
-// that care about that key.
-std::unordered_map<
-    PyObject*,
-    std::unordered_map<PyObject*, std::set<GlobalCache>>>
-    g_dict_watchers;
+// The caches watching one key of a dict. Keys are almost always watched by a
+// single cache per dict, so the first cache is stored inline and only
+// additional ones go in a separately allocated vector.
+class CacheList {
+ public:
+  bool empty() const {
+    return first_ == GlobalCache(nullptr);
+  }
+
+  size_t size() const {
+    return empty() ? 0 : rest_.size() + 1;
+  }
+
+  bool contains(GlobalCache cache) const {
+    if (empty()) {
+      return false;
+    }
+    return first_ == cache ||
+        std::find(rest_.begin(), rest_.end(), cache) != rest_.end();
+  }
+
+  // Returns false if the cache was already in the list.
+  bool add(GlobalCache cache) {
+    if (empty()) {
+      first_ = cache;
+      return true;
+    }
+    if (contains(cache)) {
+      return false;
+    }
+    rest_.push_back(cache);
+    return true;
+  }
+
+  // Returns false if the cache was not in the list.
+  bool remove(GlobalCache cache) {
+    if (empty()) {
+      return false;
+    }
+    if (first_ == cache) {
+      if (rest_.empty()) {
+        first_ = GlobalCache(nullptr);
+      } else {
+        first_ = rest_.back();
+        rest_.pop_back();
+      }
+      return true;
+    }
+    auto it = std::find(rest_.begin(), rest_.end(), cache);
+    if (it == rest_.end()) {
+      return false;
+    }
+    *it = rest_.back();
+    rest_.pop_back();
+    return true;
+  }
+
+  template <typename F>
+  void forEach(F func) const {
+    if (empty()) {
+      return;
+    }
+    func(first_);
+    for (auto cache : rest_) {
+      func(cache);
+    }
+  }
+
+  size_t overflowBytes() const {
+    return rest_.capacity() * sizeof(GlobalCache);
+  }
+
+ private:
+  GlobalCache first_{nullptr};
+  std::vector<GlobalCache> rest_;
+};
+
+// The watched keys of one dict, in an open-addressed table keyed by the
+// (interned) key.
+using DictWatchers = UnorderedMap<PyObject*, CacheList>;
+
+// For every watched dict, its watched keys. The per-dict tables are heap
+// allocated so they stay put while caches for other dicts are added or
+// removed, which can happen from inside the notification callbacks.
+UnorderedMap<PyObject*, std::unique_ptr<DictWatchers>> g_dict_watchers;
+
+DictWatchers* findDictWatchers(PyObject* dict) {
+  auto dict_it = g_dict_watchers.find(dict);
+  return dict_it == g_dict_watchers.end() ? nullptr : dict_it->second.get();
+}
+
+template <typename Map>
+size_t tableBytes(const Map& map) {
+  // One control byte per slot for the open-addressed tables.
+  return map.bucket_count() * (sizeof(typename Map::value_type) + 1);
+}
 
 void disableCaches(const std::vector<GlobalCache>& to_disable) {
   for (auto& cache : to_disable) {
@@ -31,14 +123,13 @@ void disableCaches(const std::vector<GlobalCache>& to_disable) {
 } // namespace
 
 bool isWatchedDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
-  auto dict_it = g_dict_watchers.find(dict);
-  if (dict_it == g_dict_watchers.end()) {
+  DictWatchers* watchers = findDictWatchers(dict);
+  if (watchers == nullptr) {
     return false;
   }
-  auto& dict_keys = dict_it->second;
-  auto key_it = dict_keys.find(key);
-  if (key_it != dict_keys.end()) {
-    return key_it->second.count(cache);
+  auto key_it = watchers->find(key);
+  if (key_it != watchers->end()) {
+    return key_it->second.contains(cache);
   }
   return false;
 }
@@ -46,8 +137,11 @@ bool isWatchedDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
 void watchDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
   JIT_CHECK(PyUnicode_CheckExact(key), "key must be a str");
   JIT_CHECK(PyUnicode_CHECK_INTERNED(key), "key must be interned");
-  auto& watchers = g_dict_watchers[dict][key];
-  bool inserted = watchers.emplace(cache).second;
+  auto& watchers = g_dict_watchers[dict];
+  if (watchers == nullptr) {
+    watchers = std::make_unique<DictWatchers>();
+  }
+  bool inserted = (*watchers)[key].add(cache);
   JIT_CHECK(inserted, "cache was already watching key");
   _PyDict_Watch(dict);
 }
@@ -55,13 +149,12 @@ void watchDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
 void unwatchDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
   auto dict_it = g_dict_watchers.find(dict);
   JIT_CHECK(dict_it != g_dict_watchers.end(), "dict has no watchers");
-  auto& dict_keys = dict_it->second;
+  auto& dict_keys = *dict_it->second;
   auto key_it = dict_keys.find(key);
-  JIT_CHECK(key_it != dict_it->second.end(), "key has no watchers");
+  JIT_CHECK(key_it != dict_keys.end(), "key has no watchers");
   auto& key_watchers = key_it->second;
-  auto cache_it = key_watchers.find(cache);
-  JIT_CHECK(cache_it != key_watchers.end(), "cache was not watching key");
-  key_watchers.erase(cache_it);
+  bool removed = key_watchers.remove(cache);
+  JIT_CHECK(removed, "cache was not watching key");
   if (key_watchers.empty()) {
     dict_keys.erase(key_it);
     if (dict_keys.empty()) {
@@ -71,6 +164,22 @@ void unwatchDictKey(PyObject* dict, PyObject* key, GlobalCache cache) {
   }
 }
 
+DictWatchStats getDictWatchStats() {
+  DictWatchStats stats;
+  stats.bytes = tableBytes(g_dict_watchers);
+  for (auto& dict_pair : g_dict_watchers) {
+    const DictWatchers& watchers = *dict_pair.second;
+    stats.dicts++;
+    stats.keys += watchers.size();
+    stats.bytes += sizeof(DictWatchers) + tableBytes(watchers);
+    for (auto& key_pair : watchers) {
+      stats.caches += key_pair.second.size();
+      stats.bytes += key_pair.second.overflowBytes();
+    }
+  }
+  return stats;
+}
+
 } // namespace jit
 
 void _PyJIT_NotifyDictKey(PyObject* dict, PyObject* key, PyObject* value) {
@@ -85,17 +194,16 @@ void _PyJIT_NotifyDictKey(PyObject* dict, PyObject* key, PyObject* value) {
     Py_DECREF(key);
   }
 
-  auto dict_it = jit::g_dict_watchers.find(dict);
-  JIT_CHECK(
-      dict_it != jit::g_dict_watchers.end(), "dict %p has no watchers", dict);
-  auto key_it = dict_it->second.find(key);
-  if (key_it == dict_it->second.end()) {
+  jit::DictWatchers* watchers = jit::findDictWatchers(dict);
+  JIT_CHECK(watchers != nullptr, "dict %p has no watchers", dict);
+  auto key_it = watchers->find(key);
+  if (key_it == watchers->end()) {
     return;
   }
   std::vector<jit::GlobalCache> to_disable;
-  for (auto& cache : key_it->second) {
-    cache.update(reinterpret_cast<PyObject*>(dict), value, to_disable);
-  }
+  key_it->second.forEach([&](jit::GlobalCache cache) {
+    cache.update(dict, value, to_disable);
+  });
   jit::disableCaches(to_disable);
 }
 
@@ -103,8 +211,12 @@ void _PyJIT_NotifyDictUnwatch(PyObject* dict) {
   auto dict_it = jit::g_dict_watchers.find(dict);
   JIT_CHECK(
       dict_it != jit::g_dict_watchers.end(), "dict %p has no watchers", dict);
-  for (auto& pair : dict_it->second) {
-    for (auto cache : pair.second) {
+  // Take ownership of the watchers first: unwatching keys of other dicts
+  // below can modify g_dict_watchers.
+  std::unique_ptr<jit::DictWatchers> watchers = std::move(dict_it->second);
+  jit::g_dict_watchers.erase(dict_it);
+  for (auto& pair : *watchers) {
+    pair.second.forEach([&](jit::GlobalCache cache) {
       // Unsubscribe from the corresponding globals/builtins dict if needed.
       PyObject* globals = cache.key().globals;
       PyObject* builtins = cache.key().builtins;
@@ -122,20 +234,18 @@ void _PyJIT_NotifyDictUnwatch(PyObject* dict) {
       }
 
       cache.disable();
-    }
+    });
   }
-  jit::g_dict_watchers.erase(dict_it);
 }
 
 void _PyJIT_NotifyDictClear(PyObject* dict) {
-  auto dict_it = jit::g_dict_watchers.find(dict);
-  JIT_CHECK(
-      dict_it != jit::g_dict_watchers.end(), "dict %p has no watchers", dict);
+  jit::DictWatchers* watchers = jit::findDictWatchers(dict);
+  JIT_CHECK(watchers != nullptr, "dict %p has no watchers", dict);
   std::vector<jit::GlobalCache> to_disable;
-  for (auto& key_pair : dict_it->second) {
-    for (auto& cache : key_pair.second) {
+  for (auto& key_pair : *watchers) {
+    key_pair.second.forEach([&](jit::GlobalCache cache) {
       cache.update(dict, nullptr, to_disable);
-    }
+    });
   }
   jit::disableCaches(to_disable);
 }
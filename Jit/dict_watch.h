@@ -19,6 +19,17 @@ void watchDictKey(PyObject* dict, PyObject* key, GlobalCache cache);
 // Unsubscribe from the given key of the given dict.
 void unwatchDictKey(PyObject* dict, PyObject* key, GlobalCache cache);
 
+struct DictWatchStats {
+  size_t dicts{0};
+  size_t keys{0};
+  size_t caches{0};
+  // Approximate memory used by the watcher registry.
+  size_t bytes{0};
+};
+
+// Summarize the current contents of the watcher registry.
+DictWatchStats getDictWatchStats();
+
 } // namespace jit
 
 #endif
@@ -99,6 +99,7 @@ bool isPassthrough(const Instr& instr) {
     case Opcode::kLoadGlobalCached:
     case Opcode::kLoadMethod:
     case Opcode::kLoadMethodSuper:
+    case Opcode::kLoadModuleAttrCached:
     case Opcode::kLoadTupleItem:
     case Opcode::kLoadTypeAttrCacheItem:
     case Opcode::kLoadVarObjectSize:
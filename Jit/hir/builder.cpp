@@ -28,6 +28,8 @@ namespace hir {
 
 using jit::BytecodeInstruction;
 
+long g_eval_breaker_check_interval = 1;
+
 Register* TempAllocator::Allocate() {
   Register* reg = env_->AllocateRegister();
   cache_.emplace_back(reg);
@@ -685,6 +687,16 @@ std::unique_ptr<Function> HIRBuilder::BuildHIR(
     addInitialYield(entry_tc);
   }
 
+  loop_counter_ = nullptr;
+  if (g_eval_breaker_check_interval > 1) {
+    // Allocated outside of temps_, whose registers may be handed out again
+    // for stack values.
+    loop_counter_ = irfunc->env.AllocateRegister();
+    entry_tc.emit<LoadConst>(
+        loop_counter_,
+        Type::fromCInt(g_eval_breaker_check_interval, TCInt64));
+  }
+
   BasicBlock* first_block = getBlockAtOff(0);
   if (entry_block != first_block) {
     entry_block->append<Branch>(first_block);
@@ -1296,7 +1308,9 @@ void HIRBuilder::translate(
   }
 
   for (auto block : loop_headers) {
-    insertEvalBreakerCheckForLoop(irfunc.cfg, block);
+    if (!isBoundedShortLoop(block)) {
+      insertEvalBreakerCheckForLoop(irfunc.cfg, block);
+    }
   }
 }
 
@@ -3600,6 +3614,43 @@ void HIRBuilder::insertEvalBreakerCheck(
   body.emit<Branch>(succ);
 }
 
+// A loop is bounded and short if its header is the FOR_ITER of an iterator
+// created directly from a small constant tuple or frozenset, i.e.
+//
+//   LOAD_CONST  <tuple or frozenset>
+//   GET_ITER
+//   FOR_ITER    <- loop header
+//
+// Every back-edge to the header consumes an element, so the loop runs at most
+// len(constant) times.
+bool HIRBuilder::isBoundedShortLoop(BasicBlock* loop_header) {
+  Py_ssize_t off = map_get(block_map_.bc_blocks, loop_header).startOffset();
+  Py_ssize_t idx = off / sizeof(_Py_CODEUNIT);
+  _Py_CODEUNIT* instrs = code_->co_rawcode;
+  if (idx < 2 || _Py_OPCODE(instrs[idx]) != FOR_ITER ||
+      _Py_OPCODE(instrs[idx - 1]) != GET_ITER ||
+      _Py_OPCODE(instrs[idx - 2]) != LOAD_CONST ||
+      (idx >= 3 && _Py_OPCODE(instrs[idx - 3]) == EXTENDED_ARG)) {
+    return false;
+  }
+  // If GET_ITER starts a block, the iterable may come from somewhere other
+  // than the LOAD_CONST.
+  if (block_map_.blocks.count(off - sizeof(_Py_CODEUNIT))) {
+    return false;
+  }
+  PyObject* iterable =
+      PyTuple_GET_ITEM(code_->co_consts, _Py_OPARG(instrs[idx - 2]));
+  Py_ssize_t size;
+  if (PyTuple_CheckExact(iterable)) {
+    size = PyTuple_GET_SIZE(iterable);
+  } else if (PyFrozenSet_CheckExact(iterable)) {
+    size = PySet_GET_SIZE(iterable);
+  } else {
+    return false;
+  }
+  return size <= kMaxUncheckedLoopIterations;
+}
+
 void HIRBuilder::insertEvalBreakerCheckForLoop(
     CFG& cfg,
     BasicBlock* loop_header) {
@@ -3612,7 +3663,23 @@ void HIRBuilder::insertEvalBreakerCheckForLoop(
       loop_header->id);
   auto check_block = cfg.AllocateBlock();
   loop_header->retargetPreds(check_block);
-  insertEvalBreakerCheck(cfg, check_block, loop_header, *fs);
+  if (loop_counter_ == nullptr) {
+    insertEvalBreakerCheck(cfg, check_block, loop_header, *fs);
+    return;
+  }
+  // Count down and only load the eval breaker when the counter reaches zero,
+  // resetting it for the next interval.
+  TranslationContext count(check_block, *fs);
+  auto reload_block = cfg.AllocateBlock();
+  Register* one = temps_.Allocate();
+  count.emit<LoadConst>(one, Type::fromCInt(1, TCInt64));
+  count.emit<IntBinaryOp>(
+      BinaryOpKind::kSubtract, loop_counter_, loop_counter_, one);
+  count.emit<CondBranch>(loop_counter_, loop_header, reload_block);
+  TranslationContext reload(reload_block, *fs);
+  reload.emit<LoadConst>(
+      loop_counter_, Type::fromCInt(g_eval_breaker_check_interval, TCInt64));
+  insertEvalBreakerCheck(cfg, reload_block, loop_header, *fs);
 }
 
 void HIRBuilder::insertEvalBreakerCheckForExcept(
@@ -30,6 +30,16 @@ class Register;
 
 extern const std::unordered_set<int> kSupportedOpcodes;
 
+// Number of loop back-edges a compiled function takes between checks of the
+// eval breaker. With the default of 1 the breaker is checked on every
+// back-edge; larger values keep a countdown in a register and only load the
+// breaker when it reaches zero.
+extern long g_eval_breaker_check_interval;
+
+// Loops over a constant tuple or frozenset with at most this many elements
+// run a bounded number of iterations and don't check the eval breaker.
+constexpr Py_ssize_t kMaxUncheckedLoopIterations = 16;
+
 // Helper class for managing temporary variables
 class TempAllocator {
  public:
@@ -392,6 +402,7 @@ class HIRBuilder {
       const jit::BytecodeInstruction& bc_instr);
 
   ExecutionBlock popBlock(CFG& cfg, TranslationContext& tc);
+  bool isBoundedShortLoop(BasicBlock* loop_header);
   void insertEvalBreakerCheckForLoop(CFG& cfg, BasicBlock* loop_header);
   void insertEvalBreakerCheckForExcept(CFG& cfg, TranslationContext& tc);
   void insertEvalBreakerCheck(
@@ -427,6 +438,10 @@ class HIRBuilder {
   std::unordered_map<size_t, FrameState> end_async_for_frame_state_;
 
   TempAllocator temps_{nullptr};
+
+  // Countdown to the next eval breaker check in loops, shared by all loops in
+  // the function. Null when every back-edge checks the breaker.
+  Register* loop_counter_{nullptr};
 };
 
 } // namespace hir
@@ -132,6 +132,7 @@ bool Instr::isReplayable() const {
     case Opcode::kLoadEvalBreaker:
     case Opcode::kLoadField:
     case Opcode::kLoadGlobalCached:
+    case Opcode::kLoadModuleAttrCached:
     case Opcode::kLoadTupleItem:
     case Opcode::kLoadTypeAttrCacheItem:
     case Opcode::kCast:
@@ -288,6 +288,7 @@ struct FrameState {
   V(LoadGlobal)                 \
   V(LoadMethod)                 \
   V(LoadMethodSuper)            \
+  V(LoadModuleAttrCached)       \
   V(LoadTupleItem)              \
   V(LoadTypeAttrCacheItem)      \
   V(LoadVarObjectSize)          \
@@ -2102,8 +2103,8 @@ class INSTR_CLASS(RaiseAwaitableError, Operands<1>, DeoptBase) {
   _Py_CODEUNIT with_opcode_;
 };
 
-// Load a guard (index 0) or value (index 1) from a cache specialized for
-// loading attributes from type receivers
+// Load the version tag guard (index 0) or value (index 1) from a cache
+// specialized for loading attributes from type receivers
 class INSTR_CLASS(LoadTypeAttrCacheItem, HasOutput, Operands<0>) {
  public:
   LoadTypeAttrCacheItem(Register* dst, int cache_id, int item_idx)
@@ -2334,6 +2335,43 @@ class INSTR_CLASS(LoadGlobalCached, HasOutput, Operands<0>) {
   int name_idx_;
 };
 
+// Load an attribute of a module from a cache that watches the module's dict.
+//
+// The name is specified by the name_idx in the co_names tuple of the code
+// object. The output is null if the module no longer has the attribute in
+// its dict.
+class INSTR_CLASS(LoadModuleAttrCached, HasOutput, Operands<0>) {
+ public:
+  LoadModuleAttrCached(
+      Register* dst,
+      PyObject* dict,
+      int name_idx,
+      bool is_method)
+      : InstrT(dst), dict_(dict), name_idx_(name_idx), is_method_(is_method) {}
+
+  // The dict holding the module's attributes: md_dict for regular modules
+  // and globals for strict modules.
+  PyObject* dict() const {
+    return dict_;
+  }
+
+  int name_idx() const {
+    return name_idx_;
+  }
+
+  // True if this replaced a LoadMethod. The guarded result takes the place
+  // of the callable on the stack, which the interpreter expects to find below
+  // a NULL when we deopt before the CALL_METHOD.
+  bool isMethod() const {
+    return is_method_;
+  }
+
+ private:
+  PyObject* dict_;
+  int name_idx_;
+  bool is_method_;
+};
+
 class INSTR_CLASS(LoadGlobal, HasOutput, Operands<0>, DeoptBase) {
  public:
   LoadGlobal(Register* dst, int name_idx, const FrameState& frame)
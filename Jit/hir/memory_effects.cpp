@@ -186,6 +186,7 @@ MemoryEffects memoryEffects(const Instr& inst) {
     case Opcode::kLoadFunctionIndirect:
 
     case Opcode::kLoadGlobalCached:
+    case Opcode::kLoadModuleAttrCached:
       return borrowFrom(inst, AGlobal);
 
     case Opcode::kLoadTupleItem:
@@ -4,6 +4,7 @@
 #include <fmt/format.h>
 #include <list>
 #include <memory>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -14,6 +15,7 @@
 #include "Jit/hir/printer.h"
 #include "Jit/hir/ssa.h"
 #include "Jit/jit_rt.h"
+#include "Jit/threaded_compile.h"
 #include "Jit/util.h"
 
 #include "Python.h"
@@ -310,15 +312,141 @@ void DynamicComparisonElimination::Run(Function& irfunc) {
   reflowTypes(irfunc);
 }
 
+// Try to turn a VectorCallKW with constant keyword names, whose callee is a
+// known Python function, into a plain VectorCall by resolving each keyword
+// argument to its parameter slot at compile time. This avoids building and
+// matching kwnames at runtime.
+//
+// The rewrite depends on the callee's code object, and on its defaults when a
+// keyword argument skips over a parameter, so both are guarded right after the
+// GuardIs that produced the callee. Trailing parameters that aren't passed are
+// left for the callee to fill in from its defaults at runtime.
+bool CallOptimization::ResolveKeywordArgs(Function& irfunc, VectorCallKW* call) {
+  Register* func = call->func();
+  Register* kwnames = call->arg(call->numArgs() - 1);
+  if (!func->type().hasValueSpec(TObject) || !func->instr()->IsGuardIs() ||
+      !kwnames->type().hasValueSpec(TTuple)) {
+    return false;
+  }
+  PyObject* callee = func->type().objectSpec();
+  if (Py_TYPE(callee) != &PyFunction_Type) {
+    return false;
+  }
+
+  ThreadedCompileSerialize guard;
+  auto pyfunc = reinterpret_cast<PyFunctionObject*>(callee);
+  auto code = reinterpret_cast<PyCodeObject*>(pyfunc->func_code);
+  if (code->co_kwonlyargcount != 0 ||
+      (code->co_flags & (CO_VARARGS | CO_VARKEYWORDS))) {
+    // Keyword-only arguments can't be passed positionally through
+    // _PyFunction_Vectorcall, and * or ** parameters need the generic binding.
+    return false;
+  }
+
+  PyObject* names = kwnames->type().objectSpec();
+  Py_ssize_t num_kwargs = PyTuple_GET_SIZE(names);
+  Py_ssize_t num_posargs = call->numArgs() - 1 - num_kwargs;
+  Py_ssize_t argcount = code->co_argcount;
+  if (num_posargs < 0 || num_posargs + num_kwargs > argcount) {
+    return false;
+  }
+
+  std::vector<Register*> slots(argcount, nullptr);
+  for (Py_ssize_t i = 0; i < num_posargs; i++) {
+    slots[i] = call->arg(i);
+  }
+  for (Py_ssize_t i = 0; i < num_kwargs; i++) {
+    PyObject* name = PyTuple_GET_ITEM(names, i);
+    if (!PyUnicode_CheckExact(name)) {
+      return false;
+    }
+    // Positional-only parameters can't be bound by keyword.
+    Py_ssize_t slot = code->co_posonlyargcount;
+    for (; slot < argcount; slot++) {
+      PyObject* varname = PyTuple_GET_ITEM(code->co_varnames, slot);
+      if (varname == name || _PyUnicode_EQ(varname, name)) {
+        break;
+      }
+    }
+    if (slot == argcount || slots[slot] != nullptr) {
+      // Unknown or duplicate argument; let the runtime raise the TypeError.
+      return false;
+    }
+    slots[slot] = call->arg(num_posargs + i);
+  }
+
+  PyObject* defaults = pyfunc->func_defaults;
+  Py_ssize_t first_default =
+      argcount - (defaults == nullptr ? 0 : PyTuple_GET_SIZE(defaults));
+  Py_ssize_t num_args = argcount;
+  while (num_args > 0 && slots[num_args - 1] == nullptr) {
+    num_args--;
+  }
+  bool needs_defaults = false;
+  for (Py_ssize_t i = 0; i < argcount; i++) {
+    if (slots[i] != nullptr) {
+      continue;
+    }
+    if (i < first_default) {
+      // Missing required argument.
+      return false;
+    }
+    needs_defaults |= i < num_args;
+  }
+
+  Instr* cursor = func->instr();
+  auto guard_field = [&](std::size_t offset, PyObject* expected) {
+    Register* value = irfunc.env.AllocateRegister();
+    auto load = LoadField::create(value, func, offset, TOptObject);
+    load->copyBytecodeOffset(*cursor);
+    load->InsertAfter(*cursor);
+    auto guard_is =
+        GuardIs::create(expected, irfunc.env.AllocateRegister(), value);
+    guard_is->copyBytecodeOffset(*cursor);
+    guard_is->InsertAfter(*load);
+    cursor = guard_is;
+  };
+  guard_field(offsetof(PyFunctionObject, func_code), pyfunc->func_code);
+  if (needs_defaults) {
+    guard_field(offsetof(PyFunctionObject, func_defaults), defaults);
+    for (Py_ssize_t i = first_default; i < num_args; i++) {
+      if (slots[i] != nullptr) {
+        continue;
+      }
+      slots[i] = irfunc.env.AllocateRegister();
+      auto load_default = LoadConst::create(
+          slots[i],
+          Type::fromObject(PyTuple_GET_ITEM(defaults, i - first_default)));
+      load_default->copyBytecodeOffset(*call);
+      load_default->InsertBefore(*call);
+    }
+  }
+
+  auto vectorcall =
+      VectorCall::create(num_args + 1, call->dst(), call->isAwaited());
+  vectorcall->SetOperand(0, func);
+  for (Py_ssize_t i = 0; i < num_args; i++) {
+    vectorcall->SetOperand(i + 1, slots[i]);
+  }
+  vectorcall->setFrameState(*call->frameState());
+  vectorcall->copyBytecodeOffset(*call);
+  call->ReplaceWith(*vectorcall);
+  delete call;
+  return true;
+}
+
 void CallOptimization::Run(Function& irfunc) {
-  std::vector<Instr*> cond_branches;
+  bool resolved_kwargs = false;
 
   for (auto& block : irfunc.cfg.blocks) {
     for (auto it = block.begin(); it != block.end();) {
       auto& instr = *it;
       ++it;
 
-      if (instr.IsVectorCall()) {
+      if (instr.IsVectorCallKW()) {
+        resolved_kwargs |=
+            ResolveKeywordArgs(irfunc, static_cast<VectorCallKW*>(&instr));
+      } else if (instr.IsVectorCall()) {
         auto target = instr.GetOperand(0);
         if (target->type() == type_type_ && instr.NumOperands() == 2) {
           auto load_type = LoadField::create(
@@ -333,6 +461,10 @@ void CallOptimization::Run(Function& irfunc) {
       }
     }
   }
+
+  if (resolved_kwargs) {
+    reflowTypes(irfunc);
+  }
 }
 
 void CopyPropagation::Run(Function& irfunc) {
@@ -462,19 +594,34 @@ PyObject* loadGlobal(
 
 void LoadAttrSpecialization::Run(Function& irfunc) {
   std::vector<LoadAttr*> to_specialize;
+  bool changed = false;
   for (auto& block : irfunc.cfg.GetRPOTraversal()) {
-    for (auto& instr : *block) {
+    for (auto it = block->begin(); it != block->end();) {
+      auto& instr = *it++;
+      if (instr.IsLoadMethod()) {
+        auto load_method = static_cast<LoadMethod*>(&instr);
+        changed |= specializeForModule(
+            irfunc,
+            load_method,
+            load_method->receiver(),
+            load_method->name_idx());
+        continue;
+      }
       if (!instr.IsLoadAttr()) {
         continue;
       }
 
-      if (instr.GetOperand(0)->type() <= TType) {
-        to_specialize.emplace_back(static_cast<LoadAttr*>(&instr));
+      auto load_attr = static_cast<LoadAttr*>(&instr);
+      if (load_attr->receiver()->type() <= TType) {
+        to_specialize.emplace_back(load_attr);
+      } else {
+        changed |= specializeForModule(
+            irfunc, load_attr, load_attr->receiver(), load_attr->name_idx());
       }
     }
   }
 
-  if (to_specialize.empty()) {
+  if (to_specialize.empty() && !changed) {
     return;
   }
 
@@ -485,6 +632,95 @@ void LoadAttrSpecialization::Run(Function& irfunc) {
   reflowTypes(irfunc);
 }
 
+// Look up name in the attributes of module, returning the dict that holds
+// them and the current value. Returns a null dict if the attribute can't be
+// served from a cache on that dict.
+static std::pair<PyObject*, PyObject*> lookupModuleAttr(
+    PyObject* module,
+    PyObject* name) {
+  PyObject* dict;
+  if (PyModule_CheckExact(module)) {
+    // __dict__ and __class__ are handled before the dict is consulted.
+    if (_PyUnicode_EqualToASCIIString(name, "__dict__") ||
+        _PyUnicode_EqualToASCIIString(name, "__class__")) {
+      return {nullptr, nullptr};
+    }
+    dict = reinterpret_cast<PyModuleObject*>(module)->md_dict;
+  } else if (PyStrictModule_CheckExact(module)) {
+    if (_PyUnicode_EqualToASCIIString(name, "__dict__") ||
+        _PyUnicode_EqualToASCIIString(name, "__class__") ||
+        _PyUnicode_EqualToASCIIString(name, "__name__")) {
+      return {nullptr, nullptr};
+    }
+    dict = reinterpret_cast<PyStrictModuleObject*>(module)->globals;
+    if (dict == nullptr) {
+      return {nullptr, nullptr};
+    }
+    // A name may be hidden by a corresponding <assigned:name> entry. Those are
+    // only written by the module body, before the strict module object
+    // exists, so it's enough to check for one once, here.
+    auto assigned_name =
+        Ref<>::steal(PyUnicode_FromFormat("<assigned:%U>", name));
+    if (assigned_name == nullptr) {
+      PyErr_Clear();
+      return {nullptr, nullptr};
+    }
+    if (PyDict_GetItem(dict, assigned_name) != nullptr) {
+      return {nullptr, nullptr};
+    }
+  } else {
+    return {nullptr, nullptr};
+  }
+  if (dict == nullptr || !PyDict_CheckExact(dict) || !_PyDict_CanWatch(dict)) {
+    return {nullptr, nullptr};
+  }
+  return {dict, PyDict_GetItem(dict, name)};
+}
+
+bool LoadAttrSpecialization::specializeForModule(
+    Function& irfunc,
+    Instr* instr,
+    Register* receiver,
+    int name_idx) {
+  if (!receiver->type().hasValueSpec(TObject)) {
+    return false;
+  }
+  // The guard below deopts to the start of the attribute load, with the
+  // receiver still on the stack, so we need the FrameState from right before
+  // the instruction.
+  FrameState* fs = instr->getDominatingFrameState();
+  if (fs == nullptr || fs->next_instr_offset != instr->bytecodeOffset()) {
+    return false;
+  }
+
+  PyObject* module = receiver->type().objectSpec();
+  PyObject* name = PyTuple_GET_ITEM(irfunc.code->co_names, name_idx);
+  PyObject* dict;
+  PyObject* value;
+  {
+    ThreadedCompileSerialize guard;
+    std::tie(dict, value) = lookupModuleAttr(module, name);
+  }
+  if (value == nullptr) {
+    return false;
+  }
+
+  // Like globals, the loaded value is guarded to be the object seen at
+  // compile time, so later passes can specialize on it.
+  Register* dst = instr->GetOutput();
+  Register* cached = irfunc.env.AllocateRegister();
+  auto load = LoadModuleAttrCached::create(
+      cached, dict, name_idx, instr->IsLoadMethod());
+  load->copyBytecodeOffset(*instr);
+  load->InsertBefore(*instr);
+  auto guard_is = GuardIs::create(value, dst, cached);
+  guard_is->copyBytecodeOffset(*instr);
+  instr->ReplaceWith(*guard_is);
+  delete instr;
+  dst->set_type(Type::fromObject(value));
+  return true;
+}
+
 BasicBlock* LoadAttrSpecialization::specializeForType(
     Environment& env,
     LoadAttr* load_attr) {
@@ -523,17 +759,23 @@ BasicBlock* LoadAttrSpecialization::specializeForType(
   auto phi = tail->push_front<Phi>(dst, phi_vals);
   phi->setBytecodeOffset(bc_off);
 
-  // Split control flow
+  // Split control flow on the receiver's version tag matching the cached one
+  auto version_tag = env.AllocateRegister();
+  block->appendWithOff<LoadField>(
+      bc_off,
+      version_tag,
+      receiver,
+      offsetof(PyTypeObject, tp_version_tag),
+      TCUInt32);
+  auto version_tag64 = env.AllocateRegister();
+  block->appendWithOff<IntConvert>(
+      bc_off, version_tag64, version_tag, TCUInt64);
   auto guard = env.AllocateRegister();
   block->appendWithOff<LoadTypeAttrCacheItem>(bc_off, guard, cache_id, 0);
-  auto cond1 = env.AllocateRegister();
-  block->appendWithOff<Compare>(
-      bc_off, CompareOp::kIs, cond1, guard, receiver, FrameState{});
-  auto cond2 = env.AllocateRegister();
-  // TODO(bsimmers): Get rid of this once we have a type checker for HIR.
-  cond2->set_type(TCInt32);
-  block->appendWithOff<IsTruthy>(bc_off, cond2, cond1, FrameState{});
-  block->appendWithOff<CondBranch>(bc_off, cond2, fast_path, slow_path);
+  auto cond = env.AllocateRegister();
+  block->appendWithOff<IntCompare>(
+      bc_off, IntCompareOp::kEqual, cond, version_tag64, guard);
+  block->appendWithOff<CondBranch>(bc_off, cond, fast_path, slow_path);
 
   // Remove the tail if it ends up being a trampoline
   if (tail->IsTrampoline()) {
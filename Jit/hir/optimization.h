@@ -117,6 +117,8 @@ class CallOptimization : public Pass {
   }
 
  private:
+  bool ResolveKeywordArgs(Function& irfunc, VectorCallKW* call);
+
   DISALLOW_COPY_AND_ASSIGN(CallOptimization);
   Type type_type_{TTop};
 };
@@ -149,6 +151,15 @@ class LoadAttrSpecialization : public Pass {
 
   BasicBlock* specializeForType(Environment& env, LoadAttr* instr);
 
+  // Replace a LoadAttr or LoadMethod on a known module object with a load
+  // from a cache watching the module's dict. Returns false if the attribute
+  // can't be cached.
+  bool specializeForModule(
+      Function& irfunc,
+      Instr* instr,
+      Register* receiver,
+      int name_idx);
+
   int cache_id_ = 0;
 };
 
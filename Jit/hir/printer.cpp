@@ -431,6 +431,13 @@ static std::string format_immediates(const Instr& instr) {
       const auto& load = static_cast<const LoadGlobalCached&>(instr);
       return format_name(load, load.name_idx());
     }
+    case Opcode::kLoadModuleAttrCached: {
+      const auto& load = static_cast<const LoadModuleAttrCached&>(instr);
+      if (load.isMethod()) {
+        return fmt::format("{}, method", format_name(load, load.name_idx()));
+      }
+      return format_name(load, load.name_idx());
+    }
     case Opcode::kLoadGlobal: {
       const auto& load = static_cast<const LoadGlobal&>(instr);
       return format_name(load, load.name_idx());
@@ -10,6 +10,7 @@
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
 #include <ostream>
 #include <queue>
 #include <string>
@@ -299,6 +300,7 @@ Type outputType(const Instr& instr) {
     case Opcode::kCallCFunc:
     case Opcode::kLoadCellItem:
     case Opcode::kLoadGlobalCached:
+    case Opcode::kLoadModuleAttrCached:
     case Opcode::kLoadTupleItem:
     case Opcode::kStealCellItem:
     case Opcode::kWaitHandleLoadWaiter:
@@ -402,15 +404,16 @@ Type outputType(const Instr& instr) {
     // Some compute their output type from either their inputs or some other
     // source.
 
-    // Executing LoadTypeAttrCacheItem<cache_id, 1> is only legal if
-    // appropriately guarded by LoadTypeAttrCacheItem<cache_id, 0>, and the
-    // former will always produce a non-null object.
+    // Item 0 is the version tag guarding the cache. Executing
+    // LoadTypeAttrCacheItem<cache_id, 1> is only legal if appropriately
+    // guarded by LoadTypeAttrCacheItem<cache_id, 0>, and the former will
+    // always produce a non-null object.
     //
     // TODO(bsimmers): We should probably split this into two instructions
     // rather than changing the output type based on the item index.
     case Opcode::kLoadTypeAttrCacheItem: {
       auto item = static_cast<const LoadTypeAttrCacheItem&>(instr).item_idx();
-      return item == 1 ? TObject : TOptObject;
+      return item == 1 ? TObject : TCUInt64;
     }
     case Opcode::kAssign:
       return instr.GetOperand(0)->type();
@@ -617,8 +620,17 @@ void SSAify::Run(Function& irfunc) {
     auto block = bb.first;
     auto ssablock = bb.second;
 
+    // Insert the phis in order of their outputs so the result doesn't depend
+    // on the iteration order of phi_nodes.
+    std::vector<Phi*> phis;
     for (auto& pair : ssablock->phi_nodes) {
-      block->push_front(pair.second);
+      phis.push_back(pair.second);
+    }
+    std::sort(phis.begin(), phis.end(), [](Phi* a, Phi* b) {
+      return a->GetOutput()->id() > b->GetOutput()->id();
+    });
+    for (auto phi : phis) {
+      block->push_front(phi);
     }
 
     delete ssablock;
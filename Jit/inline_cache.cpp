@@ -14,7 +14,6 @@
 #include "Jit/codegen/gen_asm.h"
 
 #include "Objects/dict-common.h"
-#include "switchboard.h"
 
 namespace jit {
 
@@ -22,13 +21,13 @@ AttributeMutator::AttributeMutator() {
   reset();
 }
 
-PyTypeObject* AttributeMutator::type() const {
-  return type_;
+unsigned int AttributeMutator::versionTag() const {
+  return version_tag_;
 }
 
 void AttributeMutator::reset() {
   kind_ = Kind::kEmpty;
-  type_ = nullptr;
+  version_tag_ = 0;
 }
 
 bool AttributeMutator::isEmpty() const {
@@ -37,7 +36,7 @@ bool AttributeMutator::isEmpty() const {
 
 void AttributeMutator::set_combined(PyTypeObject* type) {
   kind_ = Kind::kCombined;
-  type_ = type;
+  version_tag_ = type->tp_version_tag;
   combined_.dict_offset = type->tp_dictoffset;
 }
 
@@ -46,7 +45,7 @@ void AttributeMutator::set_split(
     Py_ssize_t val_offset,
     PyDictKeysObject* keys) {
   kind_ = Kind::kSplit;
-  type_ = type;
+  version_tag_ = type->tp_version_tag;
   split_.dict_offset = type->tp_dictoffset;
   split_.val_offset = val_offset;
   split_.keys = keys;
@@ -54,22 +53,27 @@ void AttributeMutator::set_split(
 
 void AttributeMutator::set_data_descr(PyTypeObject* type, PyObject* descr) {
   kind_ = Kind::kDataDescr;
-  type_ = type;
+  version_tag_ = type->tp_version_tag;
   data_descr_.descr = descr;
 }
 
 void AttributeMutator::set_member_descr(PyTypeObject* type, PyObject* descr) {
   kind_ = Kind::kMemberDescr;
-  type_ = type;
+  version_tag_ = type->tp_version_tag;
   member_descr_.memberdef = ((PyMemberDescrObject*)descr)->d_member;
 }
 
-void AttributeCache::typeChanged(PyTypeObject* type) {
+AttributeMutator* AttributeCache::findEntry(PyTypeObject* type) {
+  unsigned int version_tag = type->tp_version_tag;
+  if (version_tag == 0) {
+    return nullptr;
+  }
   for (auto& entry : entries_) {
-    if ((type == nullptr) || (entry.type() == type)) {
-      entry.reset();
+    if (entry.versionTag() == version_tag) {
+      return &entry;
     }
   }
+  return nullptr;
 }
 
 AttributeMutator* AttributeCache::findEmptyEntry() {
@@ -77,7 +81,22 @@ AttributeMutator* AttributeCache::findEmptyEntry() {
       entries_.begin(), entries_.end(), [](const AttributeMutator& e) {
         return e.isEmpty();
       });
-  return it == entries_.end() ? nullptr : it;
+  if (it != entries_.end()) {
+    return it;
+  }
+  for (auto& entry : entries_) {
+    entry.reset();
+  }
+  return &entries_[0];
+}
+
+// Return the version tag to fill a cache with for type, assigning one if
+// needed, or 0 if type can't be cached.
+static unsigned int cacheableVersionTag(PyTypeObject* type) {
+  if (!_PyType_AssignVersionTag(type)) {
+    return 0;
+  }
+  return type->tp_version_tag;
 }
 
 inline PyObject*
@@ -259,20 +278,23 @@ PyObject* MemberDescrMutator::getAttr(PyObject* obj) {
   return PyMember_GetOne((char*)obj, memberdef);
 }
 
-void StoreAttrCache::fill(PyTypeObject* type, PyObject* name, PyObject* descr) {
+void StoreAttrCache::fill(
+    PyTypeObject* type,
+    unsigned int version_tag,
+    PyObject* name,
+    PyObject* descr) {
   if (type->tp_dictoffset < 0 ||
       !PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE)) {
     return;
   }
 
-  AttributeMutator* mut = findEmptyEntry();
-  if (mut == nullptr) {
+  // The lookup may have run arbitrary code; don't cache its result if that
+  // modified the type.
+  if (version_tag == 0 || type->tp_version_tag != version_tag) {
     return;
   }
 
-  if (!watchType(type)) {
-    return;
-  }
+  AttributeMutator* mut = findEmptyEntry();
 
   if (descr != nullptr) {
     if (Py_TYPE(descr)->tp_descr_set != nullptr) {
@@ -316,12 +338,13 @@ StoreAttrCache::invokeSlowPath(PyObject* obj, PyObject* name, PyObject* value) {
 
   PyObject** dictptr = _PyObject_GetDictPtr(obj);
   descr = _PyType_Lookup(tp, name);
+  unsigned int version_tag = cacheableVersionTag(tp);
   if (descr != nullptr) {
     Py_INCREF(descr);
     descrsetfunc f = descr->ob_type->tp_descr_set;
     if (f != nullptr) {
       res = f(descr, obj, value);
-      fill(tp, name, descr);
+      fill(tp, version_tag, name, descr);
       goto done;
     }
   }
@@ -348,7 +371,7 @@ StoreAttrCache::invokeSlowPath(PyObject* obj, PyObject* name, PyObject* value) {
   if (descr != nullptr) {
     _PyType_ClearNoShadowingInstances(tp, descr);
   } else if (res != -1) {
-    fill(tp, name, NULL);
+    fill(tp, version_tag, name, NULL);
   }
 
 done:
@@ -368,29 +391,29 @@ PyObject* StoreAttrCache::invoke(
 
 PyObject*
 StoreAttrCache::doInvoke(PyObject* obj, PyObject* name, PyObject* value) {
-  PyTypeObject* tp = Py_TYPE(obj);
-  for (auto& entry : entries_) {
-    if (entry.type() == tp) {
-      return entry.setAttr(obj, name, value);
-    }
+  if (AttributeMutator* entry = findEntry(Py_TYPE(obj))) {
+    return entry->setAttr(obj, name, value);
   }
   return invokeSlowPath(obj, name, value);
 }
 
-void LoadAttrCache::fill(PyTypeObject* type, PyObject* name, PyObject* descr) {
+void LoadAttrCache::fill(
+    PyTypeObject* type,
+    unsigned int version_tag,
+    PyObject* name,
+    PyObject* descr) {
   if (type->tp_dictoffset < 0 ||
       !PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE)) {
     return;
   }
 
-  AttributeMutator* mut = findEmptyEntry();
-  if (mut == nullptr) {
+  // The lookup may have run arbitrary code; don't cache its result if that
+  // modified the type.
+  if (version_tag == 0 || type->tp_version_tag != version_tag) {
     return;
   }
 
-  if (!watchType(type)) {
-    return;
-  }
+  AttributeMutator* mut = findEmptyEntry();
 
   if (descr != nullptr) {
     if (Py_TYPE(descr)->tp_descr_set != nullptr) {
@@ -431,6 +454,7 @@ LoadAttrCache::invokeSlowPath(PyObject* obj, PyObject* name) {
   Py_ssize_t dictoffset = 0;
   PyObject** dictptr;
   PyObject* dict = nullptr;
+  unsigned int version_tag;
 
   Py_INCREF(name);
 
@@ -440,6 +464,7 @@ LoadAttrCache::invokeSlowPath(PyObject* obj, PyObject* name) {
   }
 
   descr = _PyType_Lookup(tp, name);
+  version_tag = cacheableVersionTag(tp);
 
   f = nullptr;
   if (descr != nullptr) {
@@ -447,7 +472,7 @@ LoadAttrCache::invokeSlowPath(PyObject* obj, PyObject* name) {
     f = descr->ob_type->tp_descr_get;
     if (f != nullptr && PyDescr_IsData(descr)) {
       res = f(descr, obj, (PyObject*)obj->ob_type);
-      fill(tp, name, descr);
+      fill(tp, version_tag, name, descr);
       goto done;
     }
   }
@@ -479,7 +504,7 @@ LoadAttrCache::invokeSlowPath(PyObject* obj, PyObject* name) {
     if (res != nullptr) {
       Py_INCREF(res);
       if (descr == nullptr) {
-        fill(tp, name, descr);
+        fill(tp, version_tag, name, descr);
       }
       Py_DECREF(dict);
       goto done;
@@ -511,24 +536,20 @@ done:
   return res;
 }
 
-// Sentinel PyObject that must never escape into user code.
-static PyObject g_emptyTypeAttrCache = {_PyObject_EXTRA_INIT 1, nullptr};
-
-void LoadTypeAttrCache::fill(PyTypeObject* type, PyObject* value) {
-  items[0] = reinterpret_cast<PyObject*>(type);
-  items[1] = value;
-  watchType(type);
+void LoadTypeAttrCache::fill(
+    PyTypeObject* type,
+    unsigned int version_tag,
+    PyObject* value) {
+  if (version_tag == 0 || type->tp_version_tag != version_tag) {
+    return;
+  }
+  this->version_tag = version_tag;
+  this->value = value;
 }
 
 void LoadTypeAttrCache::reset() {
-  // We need to return a PyObject* even in the empty case so that subsequent
-  // refcounting operations work correctly.
-  items[0] = &g_emptyTypeAttrCache;
-  items[1] = nullptr;
-}
-
-void LoadTypeAttrCache::typeChanged(PyTypeObject* /* type */) {
-  reset();
+  version_tag = kEmptyVersionTag;
+  value = nullptr;
 }
 
 LoadTypeAttrCache::LoadTypeAttrCache() {
@@ -541,11 +562,8 @@ LoadAttrCache::invoke(LoadAttrCache* cache, PyObject* obj, PyObject* name) {
 }
 
 PyObject* LoadAttrCache::doInvoke(PyObject* obj, PyObject* name) {
-  PyTypeObject* tp = Py_TYPE(obj);
-  for (auto& entry : entries_) {
-    if (entry.type() == tp) {
-      return entry.getAttr(obj, name);
-    }
+  if (AttributeMutator* entry = findEntry(Py_TYPE(obj))) {
+    return entry->getAttr(obj, name);
   }
   return invokeSlowPath(obj, name);
 }
@@ -587,6 +605,7 @@ PyObject* LoadTypeAttrCache::doInvoke(PyObject* obj, PyObject* name) {
   /* No data descriptor found on metatype. Look in tp_dict of this
    * type and its bases */
   PyObject* attribute = _PyType_Lookup(type, name);
+  unsigned int version_tag = cacheableVersionTag(type);
   if (attribute != nullptr) {
     /* Implement descriptor functionality, if any */
     Py_INCREF(attribute);
@@ -603,7 +622,7 @@ PyObject* LoadTypeAttrCache::doInvoke(PyObject* obj, PyObject* name) {
       return res;
     }
 
-    fill(type, attribute);
+    fill(type, version_tag, attribute);
 
     return attribute;
   }
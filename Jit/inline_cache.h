@@ -9,7 +9,6 @@
 #include "Jit/log.h"
 #include "Jit/ref.h"
 #include "Jit/util.h"
-#include "Jit/watcher.h"
 #include "Python.h"
 #include "classloader.h"
 
@@ -43,6 +42,10 @@ class InlineCachePool {
     return entry;
   }
 
+  std::size_t memoryUsage() const {
+    return num_entries_ * sizeof(T);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(InlineCachePool);
 
@@ -94,7 +97,7 @@ class AttributeMutator {
   };
 
   AttributeMutator();
-  PyTypeObject* type() const;
+  unsigned int versionTag() const;
   void reset();
   bool isEmpty() const;
   void set_combined(PyTypeObject* type);
@@ -108,7 +111,10 @@ class AttributeMutator {
 
  private:
   Kind kind_;
-  PyTypeObject* type_; // borrowed
+  // tp_version_tag of the type this was specialized for. Version tags are
+  // never reused, so this identifies both the type and its state; the entry
+  // stops matching as soon as the type is modified.
+  unsigned int version_tag_;
   union {
     SplitMutator split_;
     CombinedMutator combined_;
@@ -117,11 +123,14 @@ class AttributeMutator {
   };
 };
 
-class AttributeCache : public TypeWatcher<AttributeCache> {
- public:
-  void typeChanged(PyTypeObject* type);
-
+class AttributeCache {
  protected:
+  // Return the entry for type, or nullptr if there is none.
+  AttributeMutator* findEntry(PyTypeObject* type);
+
+  // Return an entry to fill for a new type. Entries for modified or dead
+  // types can't be told apart from live ones, so when the cache is full all
+  // entries are dropped.
   AttributeMutator* findEmptyEntry();
 
   std::array<AttributeMutator, 4> entries_;
@@ -145,7 +154,11 @@ class StoreAttrCache : public AttributeCache {
 
   PyObject* doInvoke(PyObject* obj, PyObject* name, PyObject* value);
   PyObject* invokeSlowPath(PyObject* obj, PyObject* name, PyObject* value);
-  void fill(PyTypeObject* type, PyObject* name, PyObject* descr);
+  void fill(
+      PyTypeObject* type,
+      unsigned int version_tag,
+      PyObject* name,
+      PyObject* descr);
 };
 
 // A cache for an individual LoadAttr instruction.
@@ -165,34 +178,40 @@ class LoadAttrCache : public AttributeCache {
 
   PyObject* doInvoke(PyObject* obj, PyObject* name);
   PyObject* invokeSlowPath(PyObject* obj, PyObject* name);
-  void fill(PyTypeObject* type, PyObject* name, PyObject* descr);
+  void fill(
+      PyTypeObject* type,
+      unsigned int version_tag,
+      PyObject* name,
+      PyObject* descr);
 };
 
 // A cache for LoadAttr instructions where we expect the receiver to be a type
 // object.
 //
-// The first entry in `items` is a type object. The second entry in `items` is
-// the cached value.  Both are borrowed references.
+// `version_tag` holds the tp_version_tag of the type the cache was filled
+// for, zero-extended to 64 bits, or kEmptyVersionTag, which no type's tag
+// can match. `value` is the cached value, a borrowed reference.
 //
 // The code for loading an attribute where the expected receiver is a type is
-// specialized into a fast path and a slow path. The first element is loaded
-// from the cache and compared against the receiver. If they are equal, the
-// second element (the cached value) is loaded. If they are not equal,
-// `invoke()` is called, which performs the full lookup and potentially fills
-// the cache.
-class LoadTypeAttrCache : public TypeWatcher<LoadTypeAttrCache> {
+// specialized into a fast path and a slow path. The version tag is loaded
+// from the cache and compared against the receiver's tp_version_tag. If they
+// are equal, the cached value is loaded. If they are not equal, `invoke()` is
+// called, which performs the full lookup and potentially fills the cache.
+class LoadTypeAttrCache {
  public:
+  static constexpr uint64_t kEmptyVersionTag = ~uint64_t{0};
+
   LoadTypeAttrCache();
 
   static PyObject*
   invoke(LoadTypeAttrCache* cache, PyObject* obj, PyObject* name);
   PyObject* doInvoke(PyObject* obj, PyObject* name);
-  void typeChanged(PyTypeObject* type);
 
-  std::array<PyObject*, 2> items; // Borrowed
+  uint64_t version_tag;
+  PyObject* value; // Borrowed
 
  private:
-  void fill(PyTypeObject* type, PyObject* value);
+  void fill(PyTypeObject* type, unsigned int version_tag, PyObject* value);
   void reset();
 };
 
@@ -268,6 +287,10 @@ class GlobalCache {
     return pair_ < other.pair_;
   }
 
+  bool operator==(const GlobalCache& other) const {
+    return pair_ == other.pair_;
+  }
+
  private:
   GlobalCacheMap::value_type* pair_;
 };
@@ -1251,29 +1251,50 @@ void JITRT_DoRaise(PyThreadState* tstate, PyObject* exc, PyObject* cause) {
   _Py_DoRaise(tstate, exc, cause);
 }
 
-// JIT generator data free-list globals
+// JIT generator data free lists, one per size class. Size class i holds spill
+// areas of kMinGenSpillWords + i * kGenDataSizeClassWords words; anything
+// bigger than the last class goes straight to malloc/free.
+const size_t kGenDataSizeClassWords = 32;
+const size_t kGenDataNumSizeClasses = 8;
 const size_t kGenDataFreeListMaxSize = 1024;
-static size_t gen_data_free_list_size = 0;
-static void* gen_data_free_list_tail;
-
-static void* gen_data_allocate(size_t spill_words) {
-  if (spill_words > jit::kMinGenSpillWords || !gen_data_free_list_size) {
-    auto data =
-        malloc(spill_words * sizeof(uint64_t) + sizeof(jit::GenDataFooter));
-    auto footer = reinterpret_cast<jit::GenDataFooter*>(
-        reinterpret_cast<uint64_t*>(data) + spill_words);
-    footer->spillWords = spill_words;
-    return data;
-  }
-
-  // All free list entries are spill-word size 89, so we don't need to set
-  // footer->spillWords again, it should still be set to 89 from previous use.
-  JIT_DCHECK(spill_words == jit::kMinGenSpillWords, "invalid size");
-
-  gen_data_free_list_size--;
-  auto res = gen_data_free_list_tail;
-  gen_data_free_list_tail = *reinterpret_cast<void**>(gen_data_free_list_tail);
-  return res;
+
+struct GenDataFreeList {
+  size_t size;
+  void* tail;
+};
+static GenDataFreeList gen_data_free_lists[kGenDataNumSizeClasses];
+
+static inline size_t gen_data_size_class(size_t spill_words) {
+  JIT_DCHECK(spill_words >= jit::kMinGenSpillWords, "spill area too small");
+  return (spill_words - jit::kMinGenSpillWords + kGenDataSizeClassWords - 1) /
+      kGenDataSizeClassWords;
+}
+
+// Returns a pointer to the footer of the new generator data, which is what
+// gi_jit_data points to.
+static jit::GenDataFooter* gen_data_allocate(size_t spill_words) {
+  size_t size_class = gen_data_size_class(spill_words);
+  if (size_class < kGenDataNumSizeClasses) {
+    // Round up so the area can be reused by any generator in the same class.
+    spill_words =
+        jit::kMinGenSpillWords + size_class * kGenDataSizeClassWords;
+    GenDataFreeList& free_list = gen_data_free_lists[size_class];
+    if (free_list.size) {
+      // footer->spillWords is still set from the previous use of the area.
+      free_list.size--;
+      auto res = free_list.tail;
+      free_list.tail = *reinterpret_cast<void**>(free_list.tail);
+      return reinterpret_cast<jit::GenDataFooter*>(
+          reinterpret_cast<uint64_t*>(res) + spill_words);
+    }
+  }
+
+  auto data =
+      malloc(spill_words * sizeof(uint64_t) + sizeof(jit::GenDataFooter));
+  auto footer = reinterpret_cast<jit::GenDataFooter*>(
+      reinterpret_cast<uint64_t*>(data) + spill_words);
+  footer->spillWords = spill_words;
+  return footer;
 }
 
 void JITRT_GenJitDataFree(PyGenObject* gen) {
@@ -1282,17 +1303,17 @@ void JITRT_GenJitDataFree(PyGenObject* gen) {
   auto gen_data = reinterpret_cast<uint64_t*>(gen_data_footer) -
       gen_data_footer->spillWords;
 
-  if (gen_data_footer->spillWords != jit::kMinGenSpillWords ||
-      gen_data_free_list_size == kGenDataFreeListMaxSize) {
+  size_t size_class = gen_data_size_class(gen_data_footer->spillWords);
+  if (size_class >= kGenDataNumSizeClasses ||
+      gen_data_free_lists[size_class].size == kGenDataFreeListMaxSize) {
     free(gen_data);
     return;
   }
 
-  if (gen_data_free_list_size) {
-    *reinterpret_cast<void**>(gen_data) = gen_data_free_list_tail;
-  }
-  gen_data_free_list_size++;
-  gen_data_free_list_tail = gen_data;
+  GenDataFreeList& free_list = gen_data_free_lists[size_class];
+  *reinterpret_cast<void**>(gen_data) = free_list.tail;
+  free_list.size++;
+  free_list.tail = gen_data;
 }
 
 enum class MakeGenObjectMode {
@@ -1348,9 +1369,7 @@ static inline PyObject* make_gen_object(
 
   spill_words = std::max(spill_words, jit::kMinGenSpillWords);
 
-  auto suspend_data = gen_data_allocate(spill_words);
-  auto footer = reinterpret_cast<jit::GenDataFooter*>(
-      reinterpret_cast<uint64_t*>(suspend_data) + spill_words);
+  auto footer = gen_data_allocate(spill_words);
   footer->resumeEntry = resume_entry;
   footer->yieldPoint = nullptr;
   footer->state = _PyJitGenState_JustStarted;
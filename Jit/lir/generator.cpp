@@ -1168,8 +1168,9 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
       case Opcode::kLoadTypeAttrCacheItem: {
         auto instr = static_cast<const LoadTypeAttrCacheItem*>(&i);
         auto cache = env_->code_rt->getLoadTypeAttrCache(instr->cache_id());
-        auto addr =
-            reinterpret_cast<uint64_t>(&(cache->items[instr->item_idx()]));
+        auto addr = instr->item_idx() == 0
+            ? reinterpret_cast<uint64_t>(&cache->version_tag)
+            : reinterpret_cast<uint64_t>(&cache->value);
         bbb.AppendCode("Load {}, {:#x}", instr->GetOutput(), addr);
         break;
       }
@@ -1495,6 +1496,18 @@ LIRGenerator::TranslatedBlock LIRGenerator::TranslateOneBasicBlock(
             reinterpret_cast<uint64_t>(cache.valuePtr()));
         break;
       }
+      case Opcode::kLoadModuleAttrCached: {
+        ThreadedCompileSerialize guard;
+        auto instr = static_cast<const LoadModuleAttrCached*>(&i);
+        PyObject* name = PyTuple_GET_ITEM(
+            GetHIRFunction()->code->co_names, instr->name_idx());
+        auto cache = env_->rt->findDictCache(instr->dict(), name);
+        bbb.AppendCode(
+            "Load {}, {:#x}",
+            instr->GetOutput(),
+            reinterpret_cast<uint64_t>(cache.valuePtr()));
+        break;
+      }
       case Opcode::kLoadGlobal: {
         auto instr = static_cast<const LoadGlobal*>(&i);
         PyObject* builtins = env_->code_rt->GetBuiltins();
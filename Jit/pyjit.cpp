@@ -15,6 +15,7 @@
 #include <thread>
 #include <unordered_set>
 
+#include "Jit/dict_watch.h"
 #include "Jit/hir/builder.h"
 #include "Jit/jit_context.h"
 #include "Jit/jit_gdb_support.h"
@@ -36,7 +37,7 @@ struct JitConfig {
   InitState init_state{JIT_NOT_INITIALIZED};
 
   int is_enabled{0};
-  FrameMode frame_mode{PY_FRAME};
+  FrameMode frame_mode{TINY_FRAME};
   int are_type_slots_enabled{0};
   int allow_jit_list_wildcards{0};
   int compile_all_static_functions{0};
@@ -363,6 +364,28 @@ static PyObject* jit_frame_mode(PyObject* /* self */, PyObject*) {
   return PyLong_FromLong(i);
 }
 
+static PyObject* get_dict_watch_stats(PyObject* /* self */, PyObject*) {
+  DictWatchStats stats = getDictWatchStats();
+  auto result = Ref<>::steal(PyDict_New());
+  if (result == nullptr) {
+    return nullptr;
+  }
+  std::pair<const char*, size_t> items[] = {
+      {"dicts", stats.dicts},
+      {"keys", stats.keys},
+      {"caches", stats.caches},
+      {"bytes", stats.bytes},
+  };
+  for (auto& item : items) {
+    auto value = Ref<>::steal(PyLong_FromSize_t(item.second));
+    if (value == nullptr ||
+        PyDict_SetItemString(result, item.first, value) < 0) {
+      return nullptr;
+    }
+  }
+  return result.release();
+}
+
 static PyObject* get_supported_opcodes(PyObject* /* self */, PyObject*) {
   auto set = Ref<>::steal(PySet_New(nullptr));
   if (set == nullptr) {
@@ -422,6 +445,11 @@ static PyMethodDef jit_methods[] = {
      get_supported_opcodes,
      METH_NOARGS,
      "Return a set of all supported opcodes, as ints."},
+    {"get_dict_watch_stats",
+     get_dict_watch_stats,
+     METH_NOARGS,
+     "Return the number of watched dicts, keys and caches, and the approximate "
+     "memory used to track them."},
     {"get_compiled_functions",
      get_compiled_functions,
      METH_NOARGS,
@@ -690,18 +718,35 @@ int _PyJIT_Initialize() {
   jit_config.init_state = JIT_INITIALIZED;
   jit_config.is_enabled = 1;
   g_jit_list = jit_list.release();
-  if (_is_flag_set("jit-tiny-frame", "PYTHONJITTINYFRAME")) {
-    jit_config.frame_mode = TINY_FRAME;
+  // Tiny frames are the default: a PyFrameObject is only materialized when
+  // something asks for it. -X jit-tiny-frame is still accepted for
+  // compatibility with existing scripts.
+  bool normal_frame =
+      _is_flag_set("jit-normal-frame", "PYTHONJITNORMALFRAME");
+  if (normal_frame) {
+    JIT_CHECK(
+        !_is_flag_set("jit-tiny-frame", "PYTHONJITTINYFRAME"),
+        "-X jit-tiny-frame and -X jit-normal-frame are mutually exclusive.");
+    jit_config.frame_mode = PY_FRAME;
   }
   if (_is_flag_set("jit-no-frame", "PYTHONJITNOFRAME")) {
     JIT_CHECK(
-        jit_config.frame_mode == PY_FRAME,
-        "-X jit-tiny-frame and -X jit-no-frame are mutually exclusive.");
+        !normal_frame,
+        "-X jit-normal-frame and -X jit-no-frame are mutually exclusive.");
     jit_config.frame_mode = NO_FRAME;
   }
   jit_config.are_type_slots_enabled = !PyJIT_IsXOptionSet("jit-no-type-slots");
   jit_config.batch_compile_workers =
       flag_long("jit-batch-compile-workers", "PYTHONJITBATCHCOMPILEWORKERS", 0);
+  long eval_breaker_interval = flag_long(
+      "jit-eval-breaker-interval", "PYTHONJITEVALBREAKERINTERVAL", 1);
+  if (eval_breaker_interval < 1) {
+    JIT_LOG(
+        "Invalid eval breaker check interval %ld, using 1",
+        eval_breaker_interval);
+    eval_breaker_interval = 1;
+  }
+  jit::hir::g_eval_breaker_check_interval = eval_breaker_interval;
   if (_is_flag_set(
           "jit-test-multithreaded-compile",
           "PYTHONJITTESTMULTITHREADEDCOMPILE")) {
@@ -825,6 +870,31 @@ int _PyJIT_Finalize() {
   return 0;
 }
 
+PyObject* _PyJIT_GetCacheMemoryStats() {
+  CacheMemoryStats stats =
+      jit::codegen::NativeGenerator::runtime()->cacheMemoryStats();
+  auto result = Ref<>::steal(PyDict_New());
+  if (result == nullptr) {
+    return nullptr;
+  }
+  std::pair<const char*, size_t> items[] = {
+      {"load_method", stats.load_method},
+      {"load_attr", stats.load_attr},
+      {"store_attr", stats.store_attr},
+      {"load_type_attr", stats.load_type_attr},
+      {"global", stats.global},
+      {"dict_watch", getDictWatchStats().bytes},
+  };
+  for (auto& item : items) {
+    auto value = Ref<>::steal(PyLong_FromSize_t(item.second));
+    if (value == nullptr ||
+        PyDict_SetItemString(result, item.first, value) < 0) {
+      return nullptr;
+    }
+  }
+  return result.release();
+}
+
 int _PyJIT_TinyFrame() {
   return jit_config.frame_mode == TINY_FRAME;
 }
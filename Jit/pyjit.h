@@ -133,6 +133,7 @@ PyAPI_FUNC(int) _PyJIT_OnJitList(PyFunctionObject* func);
 
 /*
  * Returns whether JITed code should be run on lightweight frames (tiny frames).
+ * This is the default; -X jit-normal-frame turns it off.
  *
  * Returns 1 if true and 0 otherwise.
  */
@@ -196,6 +197,12 @@ PyAPI_FUNC(PyObject**) _PyJIT_GetDictCache(PyObject* dict, PyObject* key);
  */
 PyAPI_FUNC(void) _PyJIT_ClearDictCaches(void);
 
+/*
+ * Returns a dict of the bytes used by the inline caches of JIT-compiled code,
+ * by kind, or NULL with an exception set on error.
+ */
+PyAPI_FUNC(PyObject*) _PyJIT_GetCacheMemoryStats(void);
+
 /*
  * Send into/resume a suspended JIT generator and return the result.
  */
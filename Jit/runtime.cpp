@@ -97,6 +97,24 @@ _PyTypedArgsInfo* Runtime::findFunctionPrimitiveArgInfo(
   return cache->second.arg_info.get();
 }
 
+CacheMemoryStats Runtime::cacheMemoryStats() {
+  // Serialize as compile threads may be adding runtimes.
+  ThreadedCompileSerialize guard;
+  CacheMemoryStats stats;
+  for (auto& code_rt : runtimes_) {
+    code_rt->addCacheMemoryStats(stats);
+  }
+  // Each global cache is a hash table node holding the key and a separately
+  // allocated value slot.
+  std::size_t global_cache_size = sizeof(GlobalCacheMap::value_type) +
+      sizeof(void*) + sizeof(PyObject*);
+  stats.global = global_caches_.size() * global_cache_size +
+      global_caches_.bucket_count() * sizeof(void*) +
+      orphaned_global_caches_.capacity() * sizeof(GlobalCacheValue) +
+      orphaned_global_caches_.size() * sizeof(PyObject*);
+  return stats;
+}
+
 void Runtime::forgetLoadGlobalCache(GlobalCache cache) {
   auto it = global_caches_.find(cache.key());
   orphaned_global_caches_.emplace_back(std::move(it->second));
@@ -38,6 +38,10 @@ class LoadMethodCachePool {
     return entry;
   }
 
+  std::size_t memoryUsage() const {
+    return num_entries_ * sizeof(JITRT_LoadMethodCache);
+  }
+
  private:
   DISALLOW_COPY_AND_ASSIGN(LoadMethodCachePool);
 
@@ -133,6 +137,15 @@ class GenYieldPoint {
   const ptrdiff_t yieldFromOffs_;
 };
 
+// Bytes used by the inline caches of compiled code, by kind.
+struct CacheMemoryStats {
+  std::size_t load_method{0};
+  std::size_t load_attr{0};
+  std::size_t store_attr{0};
+  std::size_t load_type_attr{0};
+  std::size_t global{0};
+};
+
 // Runtime data for a PyCodeObject object, containing caches and any other data
 // associated with a JIT-compiled function.
 class CodeRuntime {
@@ -152,6 +165,7 @@ class CodeRuntime {
         store_attr_cache_pool_(num_sa_caches),
         load_type_attr_caches_(
             std::make_unique<LoadTypeAttrCache[]>(num_lat_caches)),
+        num_load_type_attr_caches_(num_lat_caches),
         globals_(globals),
         builtins_(PyEval_GetBuiltins()) {
     // TODO(T88040922): Until we work out something smarter, force code and
@@ -196,6 +210,16 @@ class CodeRuntime {
     return &load_type_attr_caches_[id];
   }
 
+  // Add the memory used by this code's caches to stats. The caches are
+  // allocated up front when the code is compiled and live as long as it does.
+  void addCacheMemoryStats(CacheMemoryStats& stats) const {
+    stats.load_method += load_method_cache_pool_.memoryUsage();
+    stats.load_attr += load_attr_cache_pool_.memoryUsage();
+    stats.store_attr += store_attr_cache_pool_.memoryUsage();
+    stats.load_type_attr +=
+        num_load_type_attr_caches_ * sizeof(LoadTypeAttrCache);
+  }
+
   // Ensure that this CodeRuntime owns a reference to the given object, keeping
   // it alive for use by the compiled code.
   void addReference(PyObject* obj);
@@ -213,6 +237,7 @@ class CodeRuntime {
   InlineCachePool<LoadAttrCache> load_attr_cache_pool_;
   InlineCachePool<StoreAttrCache> store_attr_cache_pool_;
   std::unique_ptr<LoadTypeAttrCache[]> load_type_attr_caches_;
+  std::size_t num_load_type_attr_caches_;
   BorrowedRef<PyDictObject> globals_;
   BorrowedRef<PyDictObject> builtins_;
 
@@ -277,6 +302,9 @@ class Runtime {
   // Release any references this Runtime holds to Python objects.
   void releaseReferences();
 
+  // Memory used by the caches of all compiled code and the global caches.
+  CacheMemoryStats cacheMemoryStats();
+
  private:
   std::vector<std::unique_ptr<CodeRuntime>> runtimes_;
   GlobalCacheMap global_caches_;
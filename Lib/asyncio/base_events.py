@@ -51,6 +51,13 @@ from .log import logger
 
 __all__ = 'BaseEventLoop',
 
+try:
+    # Ring buffer of handles that the C versions of call_soon() and of the
+    # callback loop in _run_once() work with directly.
+    from _asyncio import ReadyQueue as _ReadyQueue
+except ImportError:
+    _ReadyQueue = collections.deque
+
 
 # Minimum number of _scheduled timer handles before cleanup of
 # cancelled handles is performed.
@@ -387,7 +394,7 @@ class BaseEventLoop(events.AbstractEventLoop):
         self._timer_cancelled_count = 0
         self._closed = False
         self._stopping = False
-        self._ready = collections.deque()
+        self._ready = _ReadyQueue()
         self._scheduled = []
         self._default_executor = None
         self._internal_fds = 0
@@ -1840,6 +1847,10 @@ class BaseEventLoop(events.AbstractEventLoop):
         # they will be run the next time (after another I/O poll).
         # Use an idiom that is thread-safe without using locks.
         ntodo = len(self._ready)
+        if not self._debug and type(self._ready) is not collections.deque:
+            # C version of the loop below
+            self._ready._run(ntodo)
+            return
         for i in range(ntodo):
             handle = self._ready.popleft()
             if handle._cancelled:
@@ -790,3 +790,18 @@ else:
     _c__set_running_loop = _set_running_loop
     _c_get_running_loop = get_running_loop
     _c_get_event_loop = get_event_loop
+
+
+_PyHandle = Handle
+_PyTimerHandle = TimerHandle
+
+try:
+    # Handles are created for every callback scheduled on the loop; the C
+    # versions are allocated from a free list and can be queued and run
+    # by the loop without going through Python.
+    from _asyncio import Handle, TimerHandle
+except ImportError:
+    pass
+else:
+    _CHandle = Handle
+    _CTimerHandle = TimerHandle
@@ -279,6 +279,16 @@ def_op("LOAD_ATTR_SUPER", 199)
 hasconst.append(199)
 
 # facebook begin - shadow byte codes
+shadow_op("LOAD_ATTR_MEGAMORPHIC", 200)
+shadow_op("LOAD_METHOD_MEGAMORPHIC", 201)
+shadow_op("BINARY_ADD_INT", 202)
+shadow_op("BINARY_ADD_FLOAT", 203)
+shadow_op("COMPARE_OP_INT", 204)
+shadow_op("BINARY_SUBSCR_LIST_INT", 205)
+shadow_op("STORE_SUBSCR_LIST_INT", 206)
+shadow_op("CALL_FUNCTION_PYFUNC", 207)
+shadow_op("CALL_FUNCTION_CFUNC", 208)
+shadow_op("CALL_FUNCTION_TYPE", 209)
 shadow_op("LOAD_ATTR_S_MODULE", 211)
 shadow_op("LOAD_METHOD_S_MODULE", 212)
 shadow_op("INVOKE_FUNCTION_CACHED", 213)
@@ -421,7 +421,7 @@ class ShareableTypeTests(unittest.TestCase):
 ##################################
 # interpreter tests
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class ListAllTests(TestBase):
 
     def test_initial(self):
@@ -445,7 +445,7 @@ class ListAllTests(TestBase):
         self.assertEqual(ids, [main, second])
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class GetCurrentTests(TestBase):
 
     def test_main(self):
@@ -469,7 +469,7 @@ class GetCurrentTests(TestBase):
         self.assertNotEqual(cur, main)
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class GetMainTests(TestBase):
 
     def test_from_main(self):
@@ -491,7 +491,7 @@ class GetMainTests(TestBase):
         self.assertEqual(main, expected)
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class IsRunningTests(TestBase):
 
     def test_main(self):
@@ -532,7 +532,7 @@ class IsRunningTests(TestBase):
             interpreters.is_running(-1)
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class InterpreterIDTests(TestBase):
 
     def test_with_int(self):
@@ -592,7 +592,7 @@ class InterpreterIDTests(TestBase):
         self.assertTrue(id1 != id3)
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class CreateTests(TestBase):
 
     def test_in_main(self):
@@ -685,7 +685,7 @@ class CreateTests(TestBase):
         id = interpreters.create()
         self.assertEqual(set(interpreters.list_all()), before | {id, id2})
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class DestroyTests(TestBase):
 
     def test_one(self):
@@ -784,7 +784,7 @@ class DestroyTests(TestBase):
             self.assertTrue(interpreters.is_running(interp))
 
 
-@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in tiny-frame mode")
+@unittest.skipUnderCinderJITNotFullFrame("T74839308 - doesn't work in no-frame mode")
 class RunStringTests(TestBase):
 
     SCRIPT = dedent("""
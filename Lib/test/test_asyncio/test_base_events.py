@@ -1,5 +1,6 @@
 """Tests for base_events.py"""
 
+import collections
 import concurrent.futures
 import errno
 import math
@@ -2152,5 +2153,88 @@ class TestSelectorUtils(test_utils.TestCase):
 
 
 
+@unittest.skipIf(base_events._ReadyQueue is collections.deque,
+                 'requires _asyncio.ReadyQueue')
+class ReadyQueueTests(test_utils.TestCase):
+
+    def setUp(self):
+        super().setUp()
+        self.loop = asyncio.new_event_loop()
+        self.set_event_loop(self.loop)
+
+    def test_fifo(self):
+        q = base_events._ReadyQueue()
+        self.assertFalse(q)
+        # enough items to grow and wrap around the ring buffer
+        for i in range(100):
+            q.append(i)
+        for i in range(60):
+            self.assertEqual(q.popleft(), i)
+        for i in range(100, 200):
+            q.append(i)
+        self.assertEqual(len(q), 140)
+        self.assertEqual(q[0], 60)
+        self.assertIn(150, q)
+        self.assertNotIn(10, q)
+        self.assertEqual(list(q), list(range(60, 200)))
+        q.clear()
+        self.assertEqual(len(q), 0)
+        with self.assertRaises(IndexError):
+            q.popleft()
+
+    def test_run(self):
+        calls = []
+        h1 = self.loop.call_soon(calls.append, 1)
+        h2 = self.loop.call_soon(calls.append, 2)
+        self.loop.call_soon(calls.append, 3)
+        h2.cancel()
+        self.loop._ready._run(2)
+        self.assertEqual(calls, [1])
+        self.assertEqual(len(self.loop._ready), 1)
+        self.loop._ready._run(1)
+        self.assertEqual(calls, [1, 3])
+        self.assertIsInstance(h1, asyncio.Handle)
+
+    def test_run_exception(self):
+        def fail():
+            raise ZeroDivisionError
+
+        self.loop.call_exception_handler = mock.Mock()
+        h = self.loop.call_soon(fail)
+        self.loop._ready._run(1)
+        self.loop.call_exception_handler.assert_called_with({
+            'message': test_utils.MockPattern('Exception in callback.*fail'),
+            'exception': mock.ANY,
+            'handle': h,
+        })
+
+    def test_task_step_scheduled_into_ready_queue(self):
+        async def coro():
+            pass
+
+        task = self.loop.create_task(coro())
+        self.assertEqual(len(self.loop._ready), 1)
+        handle = self.loop._ready[0]
+        self.assertIs(type(handle), asyncio.Handle)
+        self.loop.run_until_complete(task)
+
+    def test_call_soon_override(self):
+        calls = []
+
+        class Loop(asyncio.SelectorEventLoop):
+            def call_soon(self, callback, *args, context=None):
+                calls.append(callback)
+                return super().call_soon(callback, *args, context=context)
+
+        loop = Loop()
+        self.addCleanup(loop.close)
+
+        async def coro():
+            return 42
+
+        self.assertEqual(loop.run_until_complete(coro()), 42)
+        self.assertTrue(calls)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,156 @@
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+import asyncio
+import _asyncio
+import unittest
+
+
+class E(Exception):
+    pass
+
+
+async def sync_value(v):
+    return v
+
+
+async def sync_raise():
+    raise E()
+
+
+async def suspend_value(v):
+    await asyncio.sleep(0)
+    return v
+
+
+@unittest.skipUnless(hasattr(_asyncio, 'eager_gather'), 'requires _asyncio.eager_gather')
+class EagerGatherTest(unittest.TestCase):
+    def setUp(self) -> None:
+        loop = asyncio.new_event_loop()
+        asyncio.set_event_loop(loop)
+        self.loop = loop
+
+    def tearDown(self):
+        self.loop.close()
+        asyncio.set_event_loop_policy(None)
+
+    def test_all_complete_synchronously(self):
+        fut = _asyncio.eager_gather(sync_value(1), sync_value(2), loop=self.loop)
+        self.assertTrue(fut.done())
+        self.assertEqual(fut.result(), [1, 2])
+        # nothing was scheduled on the loop
+        self.assertEqual(len(self.loop._ready), 0)
+
+    def test_empty(self):
+        fut = _asyncio.eager_gather(loop=self.loop)
+        self.assertTrue(fut.done())
+        self.assertEqual(fut.result(), [])
+
+    def test_some_suspend(self):
+        started = []
+
+        async def child(v):
+            started.append(v)
+            return await suspend_value(v)
+
+        fut = _asyncio.eager_gather(
+            sync_value(1), child(2), sync_value(3), loop=self.loop
+        )
+        # children ran up to their first suspension
+        self.assertEqual(started, [2])
+        self.assertFalse(fut.done())
+        self.assertEqual(self.loop.run_until_complete(fut), [1, 2, 3])
+
+    def test_exception(self):
+        fut = _asyncio.eager_gather(sync_value(1), sync_raise(), loop=self.loop)
+        self.assertTrue(fut.done())
+        self.assertIsInstance(fut.exception(), E)
+
+    def test_return_exceptions(self):
+        fut = _asyncio.eager_gather(
+            sync_value(1), sync_raise(), loop=self.loop, return_exceptions=True
+        )
+        self.assertTrue(fut.done())
+        res = fut.result()
+        self.assertEqual(res[0], 1)
+        self.assertIsInstance(res[1], E)
+
+    def test_futures_and_duplicates(self):
+        f = self.loop.create_future()
+        c = sync_value(1)
+        fut = _asyncio.eager_gather(c, f, c, loop=self.loop)
+        self.assertFalse(fut.done())
+        f.set_result(2)
+        self.assertEqual(self.loop.run_until_complete(fut), [1, 2, 1])
+
+    def test_awaited(self):
+        async def main():
+            return await _asyncio.eager_gather(sync_value(1), suspend_value(2))
+
+        self.assertEqual(self.loop.run_until_complete(main()), [1, 2])
+
+
+@unittest.skipUnless(hasattr(_asyncio, 'eager_create_task'), 'requires _asyncio.eager_create_task')
+class EagerCreateTaskTest(unittest.TestCase):
+    def setUp(self) -> None:
+        loop = asyncio.new_event_loop()
+        asyncio.set_event_loop(loop)
+        self.loop = loop
+
+    def tearDown(self):
+        self.loop.close()
+        asyncio.set_event_loop_policy(None)
+
+    def test_complete_synchronously(self):
+        fut = _asyncio.eager_create_task(sync_value(42), self.loop)
+        self.assertNotIsInstance(fut, asyncio.Task)
+        self.assertTrue(fut.done())
+        self.assertEqual(fut.result(), 42)
+        self.assertEqual(len(self.loop._ready), 0)
+
+    def test_exception(self):
+        fut = _asyncio.eager_create_task(sync_raise(), self.loop)
+        self.assertTrue(fut.done())
+        self.assertIsInstance(fut.exception(), E)
+
+    def test_cancelled(self):
+        async def cancel():
+            raise asyncio.CancelledError()
+
+        fut = _asyncio.eager_create_task(cancel(), self.loop)
+        self.assertTrue(fut.cancelled())
+
+    def test_suspend(self):
+        finished = False
+
+        async def child():
+            nonlocal finished
+            await asyncio.sleep(0)
+            finished = True
+            return 42
+
+        task = _asyncio.eager_create_task(child(), self.loop)
+        self.assertIsInstance(task, asyncio.Task)
+        self.assertFalse(finished)
+        self.assertEqual(self.loop.run_until_complete(task), 42)
+        self.assertTrue(finished)
+
+    def test_running_loop(self):
+        async def main():
+            a = _asyncio.eager_create_task(sync_value(1))
+            b = _asyncio.eager_create_task(suspend_value(2))
+            return await a + await b
+
+        self.assertEqual(self.loop.run_until_complete(main()), 3)
+
+    def test_no_running_loop(self):
+        coro = sync_value(1)
+        with self.assertRaises(RuntimeError):
+            _asyncio.eager_create_task(coro)
+        coro.close()
+
+    def test_not_a_coroutine(self):
+        with self.assertRaises(TypeError):
+            _asyncio.eager_create_task(42, self.loop)
+
+
+if __name__ == '__main__':
+    unittest.main()
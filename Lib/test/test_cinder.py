@@ -2,6 +2,8 @@
 import asyncio
 import inspect
 import sys
+import threading
+import time
 import unittest
 import weakref
 from functools import wraps
@@ -1378,5 +1380,96 @@ class CodeObjectQualnameTest(unittest.TestCase):
         co = c.replace(co_flags=c.co_flags)
         self.assertEqual(cinder._get_qualname(co), "f")
 
+
+class GILTest(unittest.TestCase):
+    def setUp(self):
+        knobs = cinder.getknobs()
+        self.addCleanup(
+            cinder.setknobs,
+            {"gilstats": knobs["gilstats"], "gilfifo": knobs["gilfifo"]},
+        )
+        self.addCleanup(sys.setswitchinterval, sys.getswitchinterval())
+        sys.setswitchinterval(0.0005)
+        cinder.clear_gil_stats()
+
+    def run_threads(self, nthreads, duration):
+        counts = [0] * nthreads
+
+        def spin(i):
+            deadline = time.monotonic() + duration
+            n = 0
+            while time.monotonic() < deadline:
+                n += 1
+            counts[i] = n
+
+        threads = [threading.Thread(target=spin, args=(i,)) for i in range(nthreads)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        return counts
+
+    def test_stats_disabled(self):
+        cinder.setknobs({"gilstats": False})
+        self.run_threads(2, 0.02)
+        stats = cinder.get_gil_stats()
+        self.assertEqual(sum(stats["wait"]), 0)
+        self.assertEqual(sum(stats["hold"]), 0)
+        self.assertEqual(stats["drop_requests"], 0)
+        self.assertEqual(stats["forced_switches"], 0)
+
+    def test_stats(self):
+        cinder.setknobs({"gilstats": True})
+        switches = cinder.get_gil_stats()["switches"]
+        self.run_threads(2, 0.05)
+        cinder.setknobs({"gilstats": False})
+
+        stats = cinder.get_gil_stats()
+        self.assertEqual(len(stats["wait"]), 32)
+        self.assertEqual(len(stats["hold"]), 32)
+        self.assertGreater(sum(stats["wait"]), 0)
+        self.assertGreater(sum(stats["hold"]), 0)
+        # Two threads spinning in Python code only switch when one of them
+        # asks the other to drop the GIL.
+        self.assertGreater(stats["drop_requests"], 0)
+        self.assertGreater(stats["forced_switches"], 0)
+        self.assertGreater(stats["switches"], switches)
+
+        cinder.clear_gil_stats()
+        stats = cinder.get_gil_stats()
+        self.assertEqual(sum(stats["wait"]), 0)
+        self.assertEqual(sum(stats["hold"]), 0)
+
+    def test_fifo(self):
+        cinder.setknobs({"gilfifo": True, "gilstats": True})
+        self.assertTrue(cinder.getknobs()["gilfifo"])
+        counts = self.run_threads(4, 0.05)
+        cinder.setknobs({"gilfifo": False, "gilstats": False})
+
+        for count in counts:
+            self.assertGreater(count, 0)
+        stats = cinder.get_gil_stats()
+        self.assertGreater(stats["forced_switches"], 0)
+
+    def test_fifo_toggle_with_waiters(self):
+        # Switching modes while threads are queued for the GIL must not
+        # strand any of them.
+        done = threading.Event()
+
+        def toggle():
+            for i in range(20):
+                cinder.setknobs({"gilfifo": i % 2 == 0})
+                time.sleep(0.001)
+            done.set()
+
+        toggler = threading.Thread(target=toggle)
+        toggler.start()
+        counts = self.run_threads(3, 0.05)
+        toggler.join()
+        self.assertTrue(done.is_set())
+        for count in counts:
+            self.assertGreater(count, 0)
+
+
 if __name__ == "__main__":
     unittest.main()
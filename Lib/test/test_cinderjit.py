@@ -6,6 +6,7 @@ import dis
 import gc
 import sys
 import threading
+import tracemalloc
 import types
 import unittest
 import warnings
@@ -20,6 +21,7 @@ except ImportError:
     from test_compiler.test_static import StaticTestBase
 
 from contextlib import contextmanager
+from test.support import script_helper
 
 try:
     import cinderjit
@@ -54,6 +56,14 @@ def _simpleFunc(a, b):
     return a, b
 
 
+def _funcWithDefaults(a, b=2, c=3):
+    return a, b, c
+
+
+def _reorderedFuncWithDefaults(a, c=3, b=2):
+    return a, b, c
+
+
 class _CallableObj:
     def __call__(self, a, b):
         return self, a, b
@@ -128,6 +138,31 @@ class CallKWArgsTests(unittest.TestCase):
     def test_call_c_func(self):
         self.assertEqual(__import__("sys", globals=None), sys)
 
+    @unittest.failUnlessJITCompiled
+    def _call_func_with_defaults(self):
+        return _funcWithDefaults(1, c=30)
+
+    def test_call_function_kw_skipping_default(self):
+        self.assertEqual(self._call_func_with_defaults(), (1, 2, 30))
+
+    def test_call_function_kw_after_defaults_change(self):
+        self.assertEqual(self._call_func_with_defaults(), (1, 2, 30))
+        old_defaults = _funcWithDefaults.__defaults__
+        _funcWithDefaults.__defaults__ = (20, 300)
+        try:
+            self.assertEqual(self._call_func_with_defaults(), (1, 20, 30))
+        finally:
+            _funcWithDefaults.__defaults__ = old_defaults
+
+    def test_call_function_kw_after_code_change(self):
+        self.assertEqual(self._call_func_with_defaults(), (1, 2, 30))
+        old_code = _funcWithDefaults.__code__
+        _funcWithDefaults.__code__ = _reorderedFuncWithDefaults.__code__
+        try:
+            self.assertEqual(self._call_func_with_defaults(), (1, 3, 30))
+        finally:
+            _funcWithDefaults.__code__ = old_code
+
 
 class CallExTests(unittest.TestCase):
     @unittest.failUnlessJITCompiled
@@ -483,6 +518,84 @@ class LoadAttrCacheTests(unittest.TestCase):
         self.assertEqual(get_foo(obj3), 400)
         self.assertEqual(get_foo(obj4), 600)
 
+    def test_type_modified(self):
+        class Base:
+            def __init__(self, foo):
+                self.foo = foo
+
+        obj = Base(100)
+        # uncached
+        self.assertEqual(get_foo(obj), 100)
+        # cached
+        self.assertEqual(get_foo(obj), 100)
+        Base.foo = property(lambda self: 200)
+        self.assertEqual(get_foo(obj), 200)
+        del Base.foo
+        self.assertEqual(get_foo(obj), 100)
+
+    def test_many_types(self):
+        classes = []
+        for i in range(10):
+
+            class Base:
+                def __init__(self, foo):
+                    self.foo = foo
+
+            classes.append(Base)
+        objs = [cls(i) for i, cls in enumerate(classes)]
+        for _ in range(3):
+            self.assertEqual([get_foo(obj) for obj in objs], list(range(10)))
+
+    def test_type_cache_cleared(self):
+        class Base:
+            def __init__(self, foo):
+                self.foo = foo
+
+        obj = Base(100)
+        self.assertEqual(get_foo(obj), 100)
+        self.assertEqual(get_foo(obj), 100)
+        sys._clear_type_cache()
+        self.assertEqual(get_foo(obj), 100)
+        Base.foo = property(lambda self: 200)
+        self.assertEqual(get_foo(obj), 200)
+
+
+class TypeAttrTarget:
+    attr = 1
+
+
+@unittest.failUnlessJITCompiled
+def get_type_attr():
+    return TypeAttrTarget.attr
+
+
+class LoadTypeAttrCacheTests(unittest.TestCase):
+    def tearDown(self):
+        TypeAttrTarget.attr = 1
+
+    def test_type_modified(self):
+        self.assertEqual(get_type_attr(), 1)
+        self.assertEqual(get_type_attr(), 1)
+        TypeAttrTarget.attr = 2
+        self.assertEqual(get_type_attr(), 2)
+
+    def test_base_modified(self):
+        class Base:
+            attr = 1
+
+        class Derived(Base):
+            pass
+
+        ns = {"Derived": Derived}
+        exec("def f():\n    return Derived.attr\n", ns)
+        f = unittest.failUnlessJITCompiled(ns["f"])
+        self.assertEqual(f(), 1)
+        self.assertEqual(f(), 1)
+        Base.attr = 2
+        self.assertEqual(f(), 2)
+        Derived.attr = 3
+        self.assertEqual(f(), 3)
+
 
 @unittest.failUnlessJITCompiled
 def set_foo(x, val):
@@ -597,6 +710,22 @@ class StoreAttrCacheTests(unittest.TestCase):
         self.assertEqual(obj1.foo, 300)
 
 
+class CacheMemoryStatsTests(unittest.TestCase):
+    def test_compiled_code_caches(self):
+        import cinder
+
+        before = cinder.get_cache_memory_stats()["jit"]
+        ns = {}
+        exec("def f(o):\n    o.x = o.y\n    return o.z()\n", ns)
+        f = unittest.failUnlessJITCompiled(ns["f"])
+        after = cinder.get_cache_memory_stats()["jit"]
+        self.assertEqual(after.keys(), before.keys())
+        if cinderjit is None:
+            return
+        for kind in ("load_attr", "store_attr", "load_method"):
+            self.assertGreater(after[kind], before[kind])
+
+
 class LoadGlobalCacheTests(unittest.TestCase):
     def setUp(self):
         global license, a_global
@@ -708,6 +837,112 @@ class LoadGlobalCacheTests(unittest.TestCase):
         finally:
             del builtins.__dict__[42]
 
+    def test_builtin_watched_by_many_modules(self):
+        # Each module has its own cache for the name, and all of them watch
+        # the same key of the builtins dict.
+        funcs = []
+        for _ in range(4):
+            ns = {"__builtins__": builtins}
+            exec("def get():\n    return a_watched_builtin\n", ns)
+            funcs.append(unittest.failUnlessJITCompiled(ns["get"]))
+        builtins.a_watched_builtin = 1
+        try:
+            self.assertEqual([f() for f in funcs], [1, 1, 1, 1])
+            if cinderjit:
+                stats = cinderjit.get_dict_watch_stats()
+                self.assertGreaterEqual(stats["caches"], 4)
+                self.assertGreater(stats["bytes"], 0)
+            builtins.a_watched_builtin = 2
+            self.assertEqual([f() for f in funcs], [2, 2, 2, 2])
+        finally:
+            del builtins.a_watched_builtin
+        for f in funcs:
+            self.assertRaises(NameError, f)
+
+
+class LoadModuleAttrCacheTests(unittest.TestCase):
+    @staticmethod
+    def compile_in(mod, src):
+        ns = {"mod": mod}
+        exec(src, ns)
+        return unittest.failUnlessJITCompiled(ns["f"])
+
+    def test_simple(self):
+        mod = types.ModuleType("mod")
+        mod.x = 1
+        f = self.compile_in(mod, "def f():\n    return mod.x\n")
+        self.assertEqual(f(), 1)
+        mod.x = 2
+        self.assertEqual(f(), 2)
+        mod.__dict__["x"] = 3
+        self.assertEqual(f(), 3)
+
+    def test_deleted_attr(self):
+        mod = types.ModuleType("mod")
+        mod.x = 1
+        f = self.compile_in(mod, "def f():\n    return mod.x\n")
+        self.assertEqual(f(), 1)
+        del mod.x
+        self.assertRaises(AttributeError, f)
+        mod.__getattr__ = lambda name: f"getattr {name}"
+        self.assertEqual(f(), "getattr x")
+        mod.x = 4
+        self.assertEqual(f(), 4)
+
+    def test_method(self):
+        mod = types.ModuleType("mod")
+        mod.func = lambda a: a + 1
+        f = self.compile_in(mod, "def f(a):\n    return mod.func(a)\n")
+        self.assertEqual(f(1), 2)
+        mod.func = lambda a: a + 2
+        self.assertEqual(f(1), 3)
+
+    def test_method_deopt_in_args(self):
+        mod = types.ModuleType("mod")
+        mod.func = lambda a: a + 1
+        ns = {"mod": mod, "arg": 1}
+        exec("def f():\n    return mod.func(arg)\n", ns)
+        f = unittest.failUnlessJITCompiled(ns["f"])
+        self.assertEqual(f(), 2)
+        # Deopts between the method load and the call.
+        ns["arg"] = 2
+        self.assertEqual(f(), 3)
+
+    def test_nested_modules(self):
+        outer = types.ModuleType("outer")
+        outer.inner = types.ModuleType("inner")
+        outer.inner.x = 1
+        f = self.compile_in(outer, "def f():\n    return mod.inner.x\n")
+        self.assertEqual(f(), 1)
+        outer.inner.x = 2
+        self.assertEqual(f(), 2)
+        outer.inner = types.ModuleType("other_inner")
+        outer.inner.x = 3
+        self.assertEqual(f(), 3)
+
+    def test_module_type_attrs(self):
+        mod = types.ModuleType("mod")
+        f = self.compile_in(mod, "def f():\n    return mod.__class__\n")
+        self.assertIs(f(), types.ModuleType)
+        mod.__dict__["__class__"] = 1
+        self.assertIs(f(), types.ModuleType)
+
+    def test_strict_module(self):
+        from cinder import StrictModule, strict_module_patch
+
+        mod = StrictModule({"__name__": "mod", "x": 1}, True)
+        f = self.compile_in(mod, "def f():\n    return mod.x\n")
+        self.assertEqual(f(), 1)
+        strict_module_patch(mod, "x", 2)
+        self.assertEqual(f(), 2)
+
+    def test_strict_module_unassigned(self):
+        from cinder import StrictModule
+
+        mod = StrictModule({"__name__": "mod", "x": 1, "<assigned:x>": False}, False)
+        f = self.compile_in(mod, "def f():\n    return mod.x\n")
+        self.assertRaises(AttributeError, f)
+
 
 class ClosureTests(unittest.TestCase):
     @unittest.failUnlessJITCompiled
@@ -953,6 +1188,114 @@ class TinyFrames(unittest.TestCase):
         c = SomeClass()
         c.jitted()
 
+    @unittest.failUnlessJITCompiled
+    def _traced_alloc(self):
+        return bytearray(4096)
+
+    def test_tracemalloc_traceback(self):
+        # tracemalloc walks the frame stack from inside the allocator, so it
+        # must not materialize tiny frames.
+        tracemalloc.start(5)
+        try:
+            obj = self._traced_alloc()
+            tb = tracemalloc.get_object_traceback(obj)
+        finally:
+            tracemalloc.stop()
+        self.assertIsNotNone(tb)
+        self.assertEqual(tb[-1].filename, __file__)
+        self.assertIn(__file__, [frame.filename for frame in tb[:-1]])
+
+
+EVAL_BREAKER_LATENCY_SCRIPT = """
+import os
+import signal
+import sys
+import threading
+import time
+import cinderjit
+
+progress = [0]
+handled_at = []
+
+
+def handler(signum, frame):
+    handled_at.append(progress[0])
+
+
+def count_to(limit, kill_at, progress):
+    i = 0
+    while i < limit:
+        if i == kill_at:
+            os.kill(os.getpid(), signal.SIGUSR1)
+        i += 1
+        progress[0] = i
+    return i
+
+
+def spin_until(flag):
+    i = 0
+    while not flag:
+        i += 1
+    return i
+
+
+def short_loop():
+    total = 0
+    for x in (1, 2, 3):
+        total += x
+    return total
+
+
+for func in (count_to, spin_until, short_loop):
+    cinderjit.force_compile(func)
+    assert cinderjit.is_jit_compiled(func), func
+
+signal.signal(signal.SIGUSR1, handler)
+kill_at = 1000
+count_to(100000, kill_at, progress)
+print("signal", handled_at[0] - kill_at)
+
+sys.setswitchinterval(0.001)
+flag = []
+thread = threading.Thread(target=flag.append, args=(1,))
+start = time.perf_counter()
+thread.start()
+spin_until(flag)
+print("gil", time.perf_counter() - start)
+thread.join()
+
+assert short_loop() == 6
+"""
+
+
+class EvalBreakerLatencyTests(unittest.TestCase):
+    def run_with_interval(self, interval):
+        rc, out, err = script_helper.assert_python_ok(
+            "-X",
+            "jit",
+            "-X",
+            f"jit-eval-breaker-interval={interval}",
+            "-c",
+            EVAL_BREAKER_LATENCY_SCRIPT,
+        )
+        results = dict(line.split() for line in out.decode().splitlines())
+        return int(results["signal"]), float(results["gil"])
+
+    def check_latency(self, interval):
+        # Pending signals are handled within interval loop iterations, and a
+        # thread waiting on the GIL gets it well within a second at a 1ms
+        # switch interval.
+        iterations, gil_wait = self.run_with_interval(interval)
+        self.assertGreaterEqual(iterations, 1)
+        self.assertLessEqual(iterations, interval)
+        self.assertLess(gil_wait, 1.0)
+
+    def test_check_every_iteration(self):
+        self.check_latency(1)
+
+    def test_counted_check(self):
+        self.check_latency(64)
+
 
 class UnwindStateTests(unittest.TestCase):
     def _raise(self):
@@ -974,6 +1317,39 @@ class UnwindStateTests(unittest.TestCase):
                 f_locals, {"self": self, "a": "hello", "b": "hello", "c": "hello"}
             )
 
+    @unittest.failUnlessJITCompiled
+    def _load_many_attrs(self, obj):
+        v0 = obj.a0
+        v1 = obj.a1
+        v2 = obj.a2
+        v3 = obj.a3
+        v4 = obj.a4
+        v5 = obj.a5
+        v6 = obj.a6
+        v7 = obj.a7
+        v8 = obj.a8
+        v9 = obj.a9
+        v10 = obj.a10
+        v11 = obj.a11
+        v12 = obj.a12
+        v13 = obj.a13
+        v14 = obj.a14
+        v15 = obj.a15
+
+    def test_locals_in_frame_after_many_deopt_exits(self):
+        # Every attribute load has its own deopt exit; make sure the exits
+        # past the first few still deopt with the right metadata.
+        obj = types.SimpleNamespace(**{f"a{i}": i for i in range(15)})
+        try:
+            self._load_many_attrs(obj)
+        except AttributeError as e:
+            f_locals = e.__traceback__.tb_next.tb_frame.f_locals
+            expected = {f"v{i}": i for i in range(15)}
+            expected.update(self=self, obj=obj)
+            self.assertEqual(f_locals, expected)
+        else:
+            self.fail("AttributeError not raised")
+
 
 class ImportTests(unittest.TestCase):
     @unittest.failUnlessJITCompiled
@@ -1062,6 +1438,32 @@ class GeneratorsTest(unittest.TestCase):
             g.send(None)
         self.assertIsNone(exc.exception.value)
 
+    def test_large_spill_data(self):
+        # Enough values live across the first yield that the generator's spill
+        # data doesn't fit in the smallest pooled size.
+        nvalues = 128
+        src = (
+            "def large_gen(n):\n"
+            + "".join(f"    v{i} = n + {i}\n" for i in range(nvalues))
+            + "    yield n\n"
+            + "    yield "
+            + " + ".join(f"v{i}" for i in range(nvalues))
+            + "\n"
+        )
+        ns = {}
+        exec(src, ns)
+        large_gen = unittest.failUnlessJITCompiled(ns["large_gen"])
+        expected = sum(range(nvalues))
+        # Create and drop several generators so spill data gets reused.
+        for n in range(4):
+            g = large_gen(n)
+            self.assertEqual(next(g), n)
+            self.assertEqual(next(g), n * nvalues + expected)
+            del g
+        gens = [large_gen(n) for n in range(4)]
+        for n, g in enumerate(gens):
+            self.assertEqual(list(g), [n, n * nvalues + expected])
+
     @unittest.failUnlessJITCompiled
     def _f2(self):
         yield 1
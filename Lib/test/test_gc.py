@@ -6,6 +6,7 @@ from test.support import (verbose, refcount_test, run_unittest,
 from test.support.script_helper import assert_python_ok, make_script
 
 import gc
+import os
 import sys
 import sysconfig
 import textwrap
@@ -956,6 +957,61 @@ class GCImmortalizeTests(unittest.TestCase):
             """
         rc, out, err = assert_python_ok('-c', code)
         self.assertEqual(out.strip(), b'False')
+
+
+@unittest.skipUnless(hasattr(os, 'fork'), 'requires os.fork')
+@unittest.skipUnless(os.path.exists('/proc/self/smaps_rollup'),
+                     'requires /proc/self/smaps_rollup')
+class GCFreezeOnForkTests(unittest.TestCase):
+    # Measure how many kB of memory shared with the parent a collection in a
+    # forked child dirties. Run in a separate process to keep the test
+    # runner's own heap out of the measurement.
+    code = """if 1:
+        import gc, os
+
+        def private_dirty():
+            with open('/proc/self/smaps_rollup') as f:
+                for line in f:
+                    if line.startswith('Private_Dirty:'):
+                        return int(line.split()[1])
+
+        gc.set_freeze_on_fork(%s)
+        heap = [{'i': [i]} for i in range(100000)]
+        r, w = os.pipe()
+        pid = os.fork()
+        if pid == 0:
+            os.close(r)
+            before = private_dirty()
+            gc.collect()
+            dirtied = private_dirty() - before
+            os.write(w, b'%%d %%d' %% (dirtied, gc.get_freeze_count()))
+            os._exit(0)
+        os.close(w)
+        with os.fdopen(r, 'rb') as f:
+            print(f.read().decode())
+        os.waitpid(pid, 0)
+        """
+
+    def run_child(self, freeze_on_fork):
+        rc, out, err = assert_python_ok('-c', self.code % freeze_on_fork)
+        dirtied, freeze_count = map(int, out.split())
+        return dirtied, freeze_count
+
+    def test_get_set(self):
+        self.assertFalse(gc.get_freeze_on_fork())
+        gc.set_freeze_on_fork(True)
+        try:
+            self.assertTrue(gc.get_freeze_on_fork())
+        finally:
+            gc.set_freeze_on_fork(False)
+        self.assertFalse(gc.get_freeze_on_fork())
+
+    def test_collect_in_child_keeps_pages_shared(self):
+        dirtied, freeze_count = self.run_child(False)
+        self.assertEqual(freeze_count, 0)
+        frozen_dirtied, freeze_count = self.run_child(True)
+        self.assertGreater(freeze_count, 100000)
+        self.assertLess(frozen_dirtied * 10, dirtied)
 # end facebook
 
 
@@ -1301,7 +1357,8 @@ def test_main():
 
     try:
         gc.collect() # Delete 2nd generation garbage
-        run_unittest(GCTests, GCTogglingTests, GCCallbackTests)
+        run_unittest(GCTests, GCTogglingTests, GCCallbackTests,
+                     GCFreezeOnForkTests)
     finally:
         gc.set_debug(debug)
         # test gc.enable() even if GC is disabled by default
@@ -19,6 +19,15 @@ except ImportError:
     cinder = None
     cached_property = None
 
+
+def _jit_compiled_code():
+    try:
+        import cinderjit
+    except ImportError:
+        return set()
+    return {f.__code__ for f in cinderjit.get_compiled_functions()}
+
+
 # Sets the number of repetitions required in order to hit caching
 REPETITION = 100
 
@@ -692,7 +701,14 @@ function grab those instances from the L2 cache'''
         self.assertEqual(f(a), 100)
         for _ in range(REPETITION):
             self.assertEqual(g(a), 200)
-        if cinder is not None:
+        try:
+            import cinderjit
+            is_jit_compiled = cinderjit.is_jit_compiled(g)
+        except ImportError:
+            is_jit_compiled = False
+        # JIT-compiled code validates its caches with type version tags and
+        # doesn't hold a weak reference to the type.
+        if cinder is not None and not is_jit_compiled:
             self.assertNotEqual(len(weakref.getweakrefs(C)), 0)
 
     def test_type_resurrection_2(self):
@@ -1350,6 +1366,101 @@ def f(x):
         for i in range(REPETITION):
             self.assertEqual(f(c), 'C')
 
+    def make_megamorphic_classes(self, count):
+        classes = []
+        for i in range(count):
+            if i % 4 == 0:
+                class C:
+                    def __init__(self, i=i):
+                        self.x = i
+            elif i % 4 == 1:
+                class C:
+                    __slots__ = ('x', )
+                    def __init__(self, i=i):
+                        self.x = i
+            elif i % 4 == 2:
+                class C:
+                    x = property(lambda self, i=i: i)
+            else:
+                class C:
+                    x = i
+            C.f = lambda self, i=i: i
+            classes.append(C)
+        return classes
+
+    def test_megamorphic_attr(self):
+        classes = self.make_megamorphic_classes(20)
+        objs = [cls() for cls in classes]
+
+        def f(x):
+            return x.x
+
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], list(range(20)))
+
+    def test_megamorphic_attr_type_modified(self):
+        classes = self.make_megamorphic_classes(20)
+        objs = [cls() for cls in classes]
+
+        def f(x):
+            return x.x
+
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], list(range(20)))
+
+        for cls in classes[2::4]:
+            cls.x = property(lambda self: -1)
+        for cls in classes[3::4]:
+            cls.x = -1
+        expected = [-1 if i % 4 > 1 else i for i in range(20)]
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], expected)
+
+        sys._clear_type_cache()
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], expected)
+
+    def test_megamorphic_attr_missing(self):
+        classes = self.make_megamorphic_classes(20)
+        objs = [cls() for cls in classes]
+
+        def f(x):
+            return x.x
+
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], list(range(20)))
+
+        del objs[0].x
+        with self.assertRaises(AttributeError):
+            f(objs[0])
+        with self.assertRaises(AttributeError):
+            f(object())
+
+    def test_megamorphic_method(self):
+        classes = self.make_megamorphic_classes(20)
+        objs = [cls() for cls in classes]
+
+        def f(x):
+            return x.f()
+
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], list(range(20)))
+
+        objs[0].f = lambda: -1
+        classes[1].f = lambda self: -2
+        expected = [-1, -2] + list(range(2, 20))
+        for _ in range(REPETITION):
+            self.assertEqual([f(obj) for obj in objs], expected)
+
+        # Types with a custom __getattr__ can't be cached
+        class D:
+            def __getattr__(self, name):
+                return lambda: name
+
+        self.assertEqual(f(D()), 'f')
+        with self.assertRaises(AttributeError):
+            f(object())
+
     def test_polymorphic_method_mutating(self):
         outer = self
         class C:
@@ -2384,6 +2495,291 @@ def f(x):
         for __ in range(REPETITION):
             self.assertEqual(f(d), "x")
 
+    def test_list_int_subscr(self):
+        l = [1, 2, 3]
+        def f(l, i):
+            return l[i]
+        for __ in range(REPETITION):
+            self.assertEqual(f(l, 0), 1)
+            self.assertEqual(f(l, -1), 3)
+        self.assertRaises(IndexError, f, l, 3)
+        self.assertRaises(IndexError, f, l, -4)
+        self.assertRaises(IndexError, f, l, 2 ** 100)
+        self.assertEqual(f(l, True), 2)
+        self.assertEqual(f(l, slice(1, None)), [2, 3])
+        self.assertEqual(f({0: "x"}, 0), "x")
+        for __ in range(REPETITION):
+            self.assertEqual(f(l, 1), 2)
+
+    def test_list_int_store_subscr(self):
+        def f(l, i, v):
+            l[i] = v
+        l = [0, 0, 0]
+        for i in range(REPETITION):
+            f(l, 0, i)
+            f(l, -1, -i)
+        self.assertEqual(l, [REPETITION - 1, 0, 1 - REPETITION])
+        self.assertRaises(IndexError, f, l, 3, 0)
+        self.assertRaises(IndexError, f, l, -4, 0)
+        self.assertRaises(IndexError, f, l, 2 ** 100, 0)
+        f(l, slice(1, None), [5])
+        self.assertEqual(l, [REPETITION - 1, 5])
+        d = {}
+        f(d, 0, 1)
+        self.assertEqual(d, {0: 1})
+        for i in range(REPETITION):
+            f(l, 1, i)
+        self.assertEqual(l, [REPETITION - 1, REPETITION - 1])
+
+    def test_binary_add_int(self):
+        def f(a, b):
+            return a + b
+        for i in range(REPETITION):
+            self.assertEqual(f(i, 1), i + 1)
+        self.assertEqual(f(2 ** 100, 2 ** 100), 2 ** 101)
+        self.assertEqual(f(1, 1.5), 2.5)
+        self.assertEqual(f(True, True), 2)
+        self.assertEqual(f("a", "b"), "ab")
+        self.assertRaises(TypeError, f, 1, "b")
+        for i in range(REPETITION):
+            self.assertEqual(f(i, 1), i + 1)
+
+    def test_binary_add_float(self):
+        def f(a, b):
+            return a + b
+        for i in range(REPETITION):
+            self.assertEqual(f(i + 0.5, 1.0), i + 1.5)
+        self.assertEqual(f(1.5, 1), 2.5)
+        self.assertEqual(f([1], [2]), [1, 2])
+        for i in range(REPETITION):
+            self.assertEqual(f(i + 0.5, 1.0), i + 1.5)
+
+    def test_inplace_add_deopt(self):
+        def f(a, b):
+            a += b
+            return a
+        for i in range(REPETITION):
+            self.assertEqual(f(i, 1), i + 1)
+            self.assertEqual(f(i + 0.5, 1.0), i + 1.5)
+        # The generic path for a quickened INPLACE_ADD must still add in place
+        l = [1]
+        self.assertIs(f(l, [2]), l)
+        self.assertEqual(l, [1, 2])
+        for i in range(REPETITION):
+            self.assertEqual(f(i, 1), i + 1)
+        l = [1]
+        self.assertIs(f(l, [2]), l)
+        self.assertEqual(l, [1, 2])
+
+    def test_compare_op_int(self):
+        def lt(a, b):
+            return a < b
+        def ge(a, b):
+            return a >= b
+        def eq(a, b):
+            return a == b
+        for i in range(REPETITION):
+            self.assertTrue(lt(i, i + 1))
+            self.assertFalse(ge(i, i + 1))
+            self.assertTrue(eq(i, i))
+        self.assertTrue(lt(2 ** 100, 2 ** 101))
+        self.assertTrue(lt(1, 1.5))
+        self.assertTrue(eq(True, 1))
+        self.assertTrue(eq("a", "a"))
+        self.assertRaises(TypeError, lt, 1, "b")
+        for i in range(REPETITION):
+            self.assertTrue(lt(-i - 1, -i))
+            if ge(i, 0):
+                pass
+            else:
+                self.fail("expected i >= 0")
+
+    def test_call_function_pyfunc(self):
+        def add(a, b):
+            return a + b
+        def add_default(a, b=2):
+            return a + b
+        def gen(a, b):
+            yield a + b
+        def f(func, a, b):
+            return func(a, b)
+        for i in range(REPETITION):
+            self.assertEqual(f(add, i, 1), i + 1)
+        self.assertEqual(f(add_default, 1, 1), 2)
+        self.assertEqual(list(f(gen, 1, 1)), [2])
+        self.assertEqual(f(lambda *args: args, 1, 2), (1, 2))
+        self.assertRaises(TypeError, f, lambda a: a, 1, 2)
+        self.assertEqual(f(max, 1, 2), 2)
+        for i in range(REPETITION):
+            self.assertEqual(f(add_default, i, 1), i + 1)
+        add.__code__ = (lambda a, b: a - b).__code__
+        self.assertEqual(f(add, 3, 1), 2)
+
+    def test_call_function_cfunc(self):
+        def f(func, a):
+            return func(a)
+        def g(func, a, b):
+            return func(a, b)
+        for i in range(REPETITION):
+            self.assertEqual(f(len, [0] * i), i)
+            self.assertTrue(g(isinstance, i, int))
+        self.assertRaises(TypeError, f, len, 1)
+        self.assertRaises(TypeError, g, isinstance, 1, 1)
+        self.assertEqual(f(abs, -1), 1)
+        self.assertEqual(f(lambda a: a * 2, 1), 2)
+        self.assertEqual(g(getattr, 1, "real"), 1)
+        for i in range(REPETITION):
+            self.assertEqual(f(len, [0] * i), i)
+            self.assertTrue(g(isinstance, i, int))
+
+    def test_call_function_type(self):
+        class C:
+            def __init__(self, value):
+                self.value = value
+        class D:
+            def __init__(self, value):
+                self.value = -value
+        def f(cls, value):
+            return cls(value)
+        for i in range(REPETITION):
+            x = f(C, i)
+            self.assertIs(type(x), C)
+            self.assertEqual(x.value, i)
+        self.assertEqual(f(D, 1).value, -1)
+        self.assertEqual(f(int, "1"), 1)
+        for i in range(REPETITION):
+            self.assertEqual(f(C, i).value, i)
+
+        def init(self, value):
+            self.value = value * 2
+        C.__init__ = init
+        self.assertEqual(f(C, 1).value, 2)
+
+        def new(cls, value):
+            return 42
+        for i in range(REPETITION):
+            self.assertEqual(f(C, i).value, i * 2)
+        C.__new__ = new
+        self.assertEqual(f(C, 1), 42)
+
+    def test_call_function_type_init_errors(self):
+        class C:
+            def __init__(self, value):
+                if value < 0:
+                    raise ValueError(value)
+                return value or None
+        def f(value):
+            return C(value)
+        for __ in range(REPETITION):
+            self.assertIs(type(f(0)), C)
+        self.assertRaises(ValueError, f, -1)
+        with self.assertRaisesRegex(
+            TypeError, "__init__\\(\\) should return None, not 'int'"
+        ):
+            f(1)
+        self.assertIs(type(f(0)), C)
+
+    @skipIf(cinder is None, "requires cinder")
+    def test_cache_memory_stats(self):
+        class C:
+            def __init__(self):
+                self.x = 1
+
+            def f(self):
+                return 2
+
+        m = type(sys)("m")
+        m.y = 3
+
+        def f(c):
+            return c.x + c.f() + m.y
+
+        before = cinder.get_cache_memory_stats()
+        for _ in range(REPETITION):
+            self.assertEqual(f(C()), 6)
+        after = cinder.get_cache_memory_stats()
+        self.assertEqual(before.keys(), after.keys())
+        self.assertEqual(
+            set(after["shadow"]),
+            {
+                "code",
+                "global",
+                "polymorphic",
+                "megamorphic",
+                "instance_attr",
+                "load_method",
+                "module_attr",
+            },
+        )
+        self.assertEqual(
+            set(after["jit"]),
+            {
+                "load_method",
+                "load_attr",
+                "store_attr",
+                "load_type_attr",
+                "global",
+                "dict_watch",
+            },
+        )
+        if f.__code__ in _jit_compiled_code():
+            return
+        for kind in ("code", "instance_attr", "load_method", "module_attr"):
+            self.assertGreater(after["shadow"][kind], before["shadow"][kind])
+
+    @skipIf(cinder is None, "requires cinder")
+    def test_compact_caches(self):
+        class C:
+            def __init__(self):
+                self.x = 1
+
+        def f(c):
+            return c.x
+
+        cold_size = sys.getsizeof(f.__code__)
+        for _ in range(REPETITION):
+            self.assertEqual(f(C()), 1)
+        if f.__code__ in _jit_compiled_code():
+            return
+        self.assertGreater(sys.getsizeof(f.__code__), cold_size)
+
+        # f has run since the last compaction, so the first one keeps its
+        # caches and the second one frees them.
+        cinder.compact_caches()
+        self.assertGreater(sys.getsizeof(f.__code__), cold_size)
+        code_bytes = cinder.get_cache_memory_stats()["shadow"]["code"]
+        self.assertGreaterEqual(cinder.compact_caches(), 1)
+        self.assertEqual(sys.getsizeof(f.__code__), cold_size)
+        self.assertLess(
+            cinder.get_cache_memory_stats()["shadow"]["code"], code_bytes
+        )
+
+        # The code warms back up and gets new caches.
+        for _ in range(REPETITION):
+            self.assertEqual(f(C()), 1)
+        self.assertGreater(sys.getsizeof(f.__code__), cold_size)
+
+    @skipIf(cinder is None, "requires cinder")
+    def test_compact_caches_on_collection(self):
+        def f():
+            return 1
+
+        cold_size = sys.getsizeof(f.__code__)
+        for _ in range(REPETITION):
+            f()
+        if f.__code__ in _jit_compiled_code():
+            return
+        knobs = cinder.getknobs()
+        cinder.setknobs({"shadowcachecompaction": True})
+        try:
+            gc.collect()
+            gc.collect()
+        finally:
+            cinder.setknobs(
+                {"shadowcachecompaction": knobs["shadowcachecompaction"]}
+            )
+        self.assertEqual(sys.getsizeof(f.__code__), cold_size)
+
     def test_polymorphic(self):
         class C:
             def __init__(self):
@@ -30,7 +30,7 @@ try:
     from cinderjit import is_jit_compiled, force_compile
     from cinderjit import jit_frame_mode
     CINDERJIT_ENABLED = True
-    if jit_frame_mode() > 0:
+    if jit_frame_mode() == 2:
         CINDERJIT_NOT_FULL_FRAME = True
 except ImportError:
     def is_jit_compiled(f):
@@ -177,7 +177,7 @@ def hasInfiniteRecursion(test):
 
 def skipUnderCinderJITNotFullFrame(reason):
     """
-    Skip tests if we're in Tiny or No Frame modes.
+    Skip tests if we're in No Frame mode.
     """
     if CINDERJIT_NOT_FULL_FRAME:
         return skip(reason)
@@ -38,8 +38,13 @@ _Py_IDENTIFIER(create_future);
 _Py_IDENTIFIER(cancelled);
 _Py_IDENTIFIER(exception);
 _Py_IDENTIFIER(set_result);
+_Py_IDENTIFIER(set_exception);
 _Py_IDENTIFIER(_log_destroy_pending);
 _Py_IDENTIFIER(_set_fut_waiter);
+_Py_IDENTIFIER(_call_soon);
+_Py_IDENTIFIER(_ready);
+_Py_IDENTIFIER(_closed);
+_Py_IDENTIFIER(_debug);
 /* facebook: method table */
 
 /* State of the _asyncio module */
@@ -51,6 +56,8 @@ static PyObject *asyncio_iscoroutine_func;
 static PyObject *asyncio_task_get_stack_func;
 static PyObject *asyncio_task_print_stack_func;
 static PyObject *asyncio_task_repr_info_func;
+static PyObject *asyncio_extract_stack_func;
+static PyObject *asyncio_format_callback_source_func;
 static PyObject *asyncio_InvalidStateError;
 static PyObject *asyncio_CancelledError;
 static PyObject *context_kwname;
@@ -1059,6 +1066,973 @@ get_or_create_method_table(PyTypeObject *type) {
     return create_method_table(type);
 }
 
+/*********************** Event loop core **************************/
+
+/* Handle and TimerHandle are C versions of asyncio.events.Handle and
+   asyncio.events.TimerHandle. Handles are allocated from a free list and
+   are queued in a ReadyQueue - a ring buffer that BaseEventLoop uses instead
+   of collections.deque for its ready callbacks. When a loop uses the stock
+   BaseEventLoop.call_soon, callbacks scheduled from C (task steps, future
+   callbacks) are appended to the ready queue directly. */
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *h_callback;
+    PyObject *h_args;
+    PyObject *h_loop;
+    PyObject *h_source_traceback;
+    PyObject *h_repr;
+    PyObject *h_context;
+    PyObject *h_weakreflist;
+    char h_cancelled;
+} HandleObj;
+
+typedef struct {
+    HandleObj th_base;
+    PyObject *th_when;
+    char th_scheduled;
+} TimerHandleObj;
+
+typedef struct {
+    PyObject_HEAD
+    PyObject **rq_items;
+    Py_ssize_t rq_head;
+    Py_ssize_t rq_len;
+    // always 0 or a power of 2
+    Py_ssize_t rq_capacity;
+} ReadyQueueObj;
+
+static PyTypeObject HandleType;
+static PyTypeObject TimerHandleType;
+static PyTypeObject ReadyQueueType;
+
+#define Handle_CheckExact(obj) (Py_TYPE(obj) == &HandleType)
+#define Handle_Check(obj) PyObject_TypeCheck(obj, &HandleType)
+#define TimerHandle_Check(obj) PyObject_TypeCheck(obj, &TimerHandleType)
+#define ReadyQueue_CheckExact(obj) (Py_TYPE(obj) == &ReadyQueueType)
+
+#define HANDLE_FREELIST_MAXLEN 255
+static HandleObj *handle_freelist = NULL;
+static Py_ssize_t handle_freelist_len = 0;
+
+static HandleObj *
+handle_alloc(void)
+{
+    HandleObj *h;
+    if (handle_freelist_len) {
+        handle_freelist_len--;
+        h = handle_freelist;
+        handle_freelist = (HandleObj *)h->h_callback;
+        _Py_NewReference((PyObject *)h);
+    }
+    else {
+        h = PyObject_GC_New(HandleObj, &HandleType);
+        if (h == NULL) {
+            return NULL;
+        }
+    }
+    h->h_callback = NULL;
+    h->h_args = NULL;
+    h->h_loop = NULL;
+    h->h_source_traceback = NULL;
+    h->h_repr = NULL;
+    h->h_context = NULL;
+    h->h_weakreflist = NULL;
+    h->h_cancelled = 0;
+    return h;
+}
+
+// Sets fields shared by all handles. 'context' may be NULL or None - in this
+// case a copy of the current context is used
+static int
+handle_set_fields(HandleObj *h,
+                  PyObject *callback,
+                  PyObject *args,
+                  PyObject *loop,
+                  PyObject *context)
+{
+    if (context == NULL || context == Py_None) {
+        context = PyContext_CopyCurrent();
+        if (context == NULL) {
+            return -1;
+        }
+    }
+    else {
+        Py_INCREF(context);
+    }
+    Py_XSETREF(h->h_context, context);
+    Py_INCREF(loop);
+    Py_XSETREF(h->h_loop, loop);
+    Py_INCREF(callback);
+    Py_XSETREF(h->h_callback, callback);
+    Py_INCREF(args);
+    Py_XSETREF(h->h_args, args);
+    Py_CLEAR(h->h_repr);
+    Py_CLEAR(h->h_source_traceback);
+    h->h_cancelled = 0;
+    return 0;
+}
+
+// Creates a handle for callbacks scheduled from C, which never
+// runs in debug mode and so has no source traceback
+static PyObject *
+handle_new(PyObject *callback, PyObject *args, PyObject *loop, PyObject *context)
+{
+    HandleObj *h = handle_alloc();
+    if (h == NULL) {
+        return NULL;
+    }
+    if (handle_set_fields(h, callback, args, loop, context) < 0) {
+        Py_DECREF(h);
+        return NULL;
+    }
+    PyObject_GC_Track(h);
+    return (PyObject *)h;
+}
+
+static PyObject *
+HandleObj_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    if (type == &HandleType) {
+        HandleObj *h = handle_alloc();
+        if (h != NULL) {
+            PyObject_GC_Track(h);
+        }
+        return (PyObject *)h;
+    }
+    return type->tp_alloc(type, 0);
+}
+
+static int
+handle_init(HandleObj *self,
+            PyObject *callback,
+            PyObject *args,
+            PyObject *loop,
+            PyObject *context)
+{
+    if (handle_set_fields(self, callback, args, loop, context) < 0) {
+        return -1;
+    }
+    PyObject *debug = _PyObject_CallMethodId(loop, &PyId_get_debug, NULL);
+    if (debug == NULL) {
+        return -1;
+    }
+    int is_debug = PyObject_IsTrue(debug);
+    Py_DECREF(debug);
+    if (is_debug < 0) {
+        return -1;
+    }
+    if (is_debug) {
+        // same as format_helpers.extract_stack(sys._getframe(1)) in __init__
+        PyObject *frame = (PyObject *)PyEval_GetFrame();
+        PyObject *tb = PyObject_CallFunctionObjArgs(
+            asyncio_extract_stack_func, frame ? frame : Py_None, NULL);
+        if (tb == NULL) {
+            return -1;
+        }
+        self->h_source_traceback = tb;
+    }
+    return 0;
+}
+
+static int
+HandleObj_init(HandleObj *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"callback", "args", "loop", "context", NULL};
+    PyObject *callback, *cb_args, *loop, *context = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO|O:Handle", kwlist,
+                                     &callback, &cb_args, &loop, &context)) {
+        return -1;
+    }
+    return handle_init(self, callback, cb_args, loop, context);
+}
+
+static int
+HandleObj_clear(HandleObj *h)
+{
+    Py_CLEAR(h->h_callback);
+    Py_CLEAR(h->h_args);
+    Py_CLEAR(h->h_loop);
+    Py_CLEAR(h->h_source_traceback);
+    Py_CLEAR(h->h_repr);
+    Py_CLEAR(h->h_context);
+    return 0;
+}
+
+static int
+HandleObj_traverse(HandleObj *h, visitproc visit, void *arg)
+{
+    Py_VISIT(h->h_callback);
+    Py_VISIT(h->h_args);
+    Py_VISIT(h->h_loop);
+    Py_VISIT(h->h_source_traceback);
+    Py_VISIT(h->h_repr);
+    Py_VISIT(h->h_context);
+    return 0;
+}
+
+static void
+HandleObj_dealloc(HandleObj *h)
+{
+    PyObject_GC_UnTrack(h);
+    if (h->h_weakreflist != NULL) {
+        PyObject_ClearWeakRefs((PyObject *)h);
+    }
+    (void)HandleObj_clear(h);
+    if (Handle_CheckExact(h) && handle_freelist_len < HANDLE_FREELIST_MAXLEN) {
+        handle_freelist_len++;
+        h->h_callback = (PyObject *)handle_freelist;
+        handle_freelist = h;
+    }
+    else {
+        Py_TYPE(h)->tp_free(h);
+    }
+}
+
+static PyObject *
+HandleObj_repr_info(HandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *info = PyList_New(0);
+    if (info == NULL) {
+        return NULL;
+    }
+    PyObject *item = PyUnicode_FromString(_PyType_Name(Py_TYPE(self)));
+    if (item == NULL || PyList_Append(info, item) < 0) {
+        goto fail;
+    }
+    Py_DECREF(item);
+    if (self->h_cancelled) {
+        item = PyUnicode_FromString("cancelled");
+        if (item == NULL || PyList_Append(info, item) < 0) {
+            goto fail;
+        }
+        Py_DECREF(item);
+    }
+    if (self->h_callback != NULL && self->h_callback != Py_None) {
+        item = PyObject_CallFunctionObjArgs(asyncio_format_callback_source_func,
+                                            self->h_callback,
+                                            self->h_args ? self->h_args : Py_None,
+                                            NULL);
+        if (item == NULL || PyList_Append(info, item) < 0) {
+            goto fail;
+        }
+        Py_DECREF(item);
+    }
+    if (self->h_source_traceback != NULL) {
+        int ok = PyObject_IsTrue(self->h_source_traceback);
+        if (ok < 0) {
+            goto fail_no_item;
+        }
+        if (ok) {
+            PyObject *frame = PySequence_GetItem(self->h_source_traceback, -1);
+            if (frame == NULL) {
+                goto fail_no_item;
+            }
+            PyObject *filename = PySequence_GetItem(frame, 0);
+            PyObject *lineno = filename ? PySequence_GetItem(frame, 1) : NULL;
+            Py_DECREF(frame);
+            item = lineno ? PyUnicode_FromFormat("created at %S:%S", filename, lineno)
+                          : NULL;
+            Py_XDECREF(filename);
+            Py_XDECREF(lineno);
+            if (item == NULL || PyList_Append(info, item) < 0) {
+                goto fail;
+            }
+            Py_DECREF(item);
+        }
+    }
+    return info;
+fail:
+    Py_XDECREF(item);
+fail_no_item:
+    Py_DECREF(info);
+    return NULL;
+}
+
+static PyObject *
+HandleObj_repr(HandleObj *self)
+{
+    _Py_IDENTIFIER(_repr_info);
+    if (self->h_repr != NULL && self->h_repr != Py_None) {
+        Py_INCREF(self->h_repr);
+        return self->h_repr;
+    }
+    PyObject *info = _PyObject_CallMethodId((PyObject *)self, &PyId__repr_info, NULL);
+    if (info == NULL) {
+        return NULL;
+    }
+    PyObject *sep = PyUnicode_FromString(" ");
+    if (sep == NULL) {
+        Py_DECREF(info);
+        return NULL;
+    }
+    PyObject *joined = PyUnicode_Join(sep, info);
+    Py_DECREF(sep);
+    Py_DECREF(info);
+    if (joined == NULL) {
+        return NULL;
+    }
+    PyObject *res = PyUnicode_FromFormat("<%U>", joined);
+    Py_DECREF(joined);
+    return res;
+}
+
+static PyObject *
+handle_cancel(HandleObj *self)
+{
+    if (self->h_cancelled) {
+        Py_RETURN_NONE;
+    }
+    self->h_cancelled = 1;
+    PyObject *debug = _PyObject_CallMethodId(self->h_loop, &PyId_get_debug, NULL);
+    if (debug == NULL) {
+        return NULL;
+    }
+    int is_debug = PyObject_IsTrue(debug);
+    Py_DECREF(debug);
+    if (is_debug < 0) {
+        return NULL;
+    }
+    if (is_debug) {
+        // Keep a representation in debug mode to keep callback and
+        // parameters. For example, to log the warning
+        // "Executing <Handle...> took 2.5 second"
+        PyObject *repr = PyObject_Repr((PyObject *)self);
+        if (repr == NULL) {
+            return NULL;
+        }
+        Py_XSETREF(self->h_repr, repr);
+    }
+    Py_CLEAR(self->h_callback);
+    Py_CLEAR(self->h_args);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+HandleObj_cancel(HandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    return handle_cancel(self);
+}
+
+static PyObject *
+HandleObj_cancelled(HandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(self->h_cancelled);
+}
+
+// Reports an exception raised by the callback to the loop exception handler.
+// SystemExit and KeyboardInterrupt are propagated.
+static PyObject *
+handle_report_exception(HandleObj *self)
+{
+    _Py_IDENTIFIER(call_exception_handler);
+    if (PyErr_ExceptionMatches(PyExc_SystemExit) ||
+        PyErr_ExceptionMatches(PyExc_KeyboardInterrupt)) {
+        return NULL;
+    }
+    PyObject *et, *ev, *tb;
+    PyErr_Fetch(&et, &ev, &tb);
+    PyErr_NormalizeException(&et, &ev, &tb);
+    if (tb != NULL) {
+        PyException_SetTraceback(ev, tb);
+    }
+    PyObject *context = NULL, *res = NULL;
+    PyObject *cb = PyObject_CallFunctionObjArgs(
+        asyncio_format_callback_source_func,
+        self->h_callback ? self->h_callback : Py_None,
+        self->h_args ? self->h_args : Py_None,
+        NULL);
+    if (cb == NULL) {
+        goto done;
+    }
+    PyObject *msg = PyUnicode_FromFormat("Exception in callback %U", cb);
+    Py_DECREF(cb);
+    if (msg == NULL) {
+        goto done;
+    }
+    context = Py_BuildValue("{sNsOsO}",
+                            "message", msg,
+                            "exception", ev,
+                            "handle", (PyObject *)self);
+    if (context == NULL) {
+        goto done;
+    }
+    if (self->h_source_traceback != NULL) {
+        int ok = PyObject_IsTrue(self->h_source_traceback);
+        if (ok < 0 ||
+            (ok && PyDict_SetItemString(context,
+                                        "source_traceback",
+                                        self->h_source_traceback) < 0)) {
+            goto done;
+        }
+    }
+    res = _PyObject_CallMethodIdObjArgs(
+        self->h_loop, &PyId_call_exception_handler, context, NULL);
+done:
+    Py_XDECREF(context);
+    Py_XDECREF(et);
+    Py_XDECREF(ev);
+    Py_XDECREF(tb);
+    return res;
+}
+
+static PyObject *
+handle_run(HandleObj *self)
+{
+    PyObject *res = NULL;
+    // keep the handle alive - callback might drop the last reference to it
+    Py_INCREF(self);
+    PyObject *callback = self->h_callback;
+    PyObject *args = self->h_args;
+    PyObject *ctx = self->h_context;
+    if (callback == NULL || args == NULL || ctx == NULL) {
+        PyErr_SetString(PyExc_TypeError, "'NoneType' object is not callable");
+    }
+    else if (PyContext_Enter(ctx) == 0) {
+        if (PyTuple_CheckExact(args)) {
+            res = _PyObject_Vectorcall(
+                callback, &PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args), NULL);
+        }
+        else {
+            PyObject *tuple = PySequence_Tuple(args);
+            if (tuple != NULL) {
+                res = PyObject_Call(callback, tuple, NULL);
+                Py_DECREF(tuple);
+            }
+        }
+        if (PyContext_Exit(ctx) < 0) {
+            Py_CLEAR(res);
+        }
+    }
+    if (res == NULL) {
+        res = handle_report_exception(self);
+    }
+    if (res != NULL) {
+        Py_DECREF(res);
+        res = Py_None;
+        Py_INCREF(res);
+    }
+    Py_DECREF(self);
+    return res;
+}
+
+static PyObject *
+HandleObj_run(HandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    return handle_run(self);
+}
+
+static PyObject *
+HandleObj_get_cancelled(HandleObj *self, void *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(self->h_cancelled);
+}
+
+static int
+HandleObj_set_cancelled(HandleObj *self, PyObject *val, void *Py_UNUSED(ignored))
+{
+    if (val == NULL) {
+        PyErr_SetString(PyExc_AttributeError, "cannot delete attribute");
+        return -1;
+    }
+    int is_true = PyObject_IsTrue(val);
+    if (is_true < 0) {
+        return -1;
+    }
+    self->h_cancelled = is_true;
+    return 0;
+}
+
+static PyMethodDef HandleType_methods[] = {
+    {"cancel", (PyCFunction)HandleObj_cancel, METH_NOARGS, NULL},
+    {"cancelled", (PyCFunction)HandleObj_cancelled, METH_NOARGS, NULL},
+    {"_run", (PyCFunction)HandleObj_run, METH_NOARGS, NULL},
+    {"_repr_info", (PyCFunction)HandleObj_repr_info, METH_NOARGS, NULL},
+    {NULL, NULL}        /* Sentinel */
+};
+
+static PyMemberDef HandleType_members[] = {
+    {"_callback", T_OBJECT, offsetof(HandleObj, h_callback), 0},
+    {"_args", T_OBJECT, offsetof(HandleObj, h_args), 0},
+    {"_loop", T_OBJECT, offsetof(HandleObj, h_loop), 0},
+    {"_source_traceback", T_OBJECT, offsetof(HandleObj, h_source_traceback), 0},
+    {"_repr", T_OBJECT, offsetof(HandleObj, h_repr), 0},
+    {"_context", T_OBJECT, offsetof(HandleObj, h_context), 0},
+    {NULL}  /* Sentinel */
+};
+
+static PyGetSetDef HandleType_getsetlist[] = {
+    {"_cancelled", (getter)HandleObj_get_cancelled, (setter)HandleObj_set_cancelled, NULL},
+    {NULL} /* Sentinel */
+};
+
+static PyTypeObject HandleType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_asyncio.Handle",
+    sizeof(HandleObj),                       /* tp_basicsize */
+    .tp_dealloc = (destructor)HandleObj_dealloc,
+    .tp_repr = (reprfunc)HandleObj_repr,
+    .tp_doc = "Object returned by callback registration methods.",
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_BASETYPE,
+    .tp_traverse = (traverseproc)HandleObj_traverse,
+    .tp_clear = (inquiry)HandleObj_clear,
+    .tp_weaklistoffset = offsetof(HandleObj, h_weakreflist),
+    .tp_methods = HandleType_methods,
+    .tp_members = HandleType_members,
+    .tp_getset = HandleType_getsetlist,
+    .tp_init = (initproc)HandleObj_init,
+    .tp_new = HandleObj_tp_new,
+};
+
+/* ----- TimerHandle */
+
+static int
+TimerHandleObj_init(TimerHandleObj *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"when", "callback", "args", "loop", "context", NULL};
+    PyObject *when, *callback, *cb_args, *loop, *context = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|O:TimerHandle", kwlist,
+                                     &when, &callback, &cb_args, &loop, &context)) {
+        return -1;
+    }
+    if (when == Py_None) {
+        PyErr_SetNone(PyExc_AssertionError);
+        return -1;
+    }
+    if (handle_init((HandleObj *)self, callback, cb_args, loop, context) < 0) {
+        return -1;
+    }
+    Py_INCREF(when);
+    Py_XSETREF(self->th_when, when);
+    self->th_scheduled = 0;
+    return 0;
+}
+
+static int
+TimerHandleObj_clear(TimerHandleObj *self)
+{
+    Py_CLEAR(self->th_when);
+    return HandleObj_clear((HandleObj *)self);
+}
+
+static int
+TimerHandleObj_traverse(TimerHandleObj *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->th_when);
+    return HandleObj_traverse((HandleObj *)self, visit, arg);
+}
+
+static void
+TimerHandleObj_dealloc(TimerHandleObj *self)
+{
+    PyObject_GC_UnTrack(self);
+    Py_CLEAR(self->th_when);
+    HandleObj_dealloc((HandleObj *)self);
+}
+
+static PyObject *
+TimerHandleObj_repr_info(TimerHandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *info = HandleObj_repr_info((HandleObj *)self, NULL);
+    if (info == NULL) {
+        return NULL;
+    }
+    PyObject *when = PyUnicode_FromFormat("when=%S", self->th_when ? self->th_when : Py_None);
+    if (when == NULL ||
+        PyList_Insert(info, self->th_base.h_cancelled ? 2 : 1, when) < 0) {
+        Py_XDECREF(when);
+        Py_DECREF(info);
+        return NULL;
+    }
+    Py_DECREF(when);
+    return info;
+}
+
+static Py_hash_t
+TimerHandleObj_hash(TimerHandleObj *self)
+{
+    return PyObject_Hash(self->th_when ? self->th_when : Py_None);
+}
+
+static PyObject *
+TimerHandleObj_richcompare(TimerHandleObj *self, PyObject *other, int op)
+{
+    if (!TimerHandle_Check(other)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+    TimerHandleObj *o = (TimerHandleObj *)other;
+    PyObject *when = self->th_when ? self->th_when : Py_None;
+    PyObject *other_when = o->th_when ? o->th_when : Py_None;
+    if (op == Py_LT || op == Py_GT) {
+        if (PyFloat_CheckExact(when) && PyFloat_CheckExact(other_when)) {
+            double a = PyFloat_AS_DOUBLE(when), b = PyFloat_AS_DOUBLE(other_when);
+            return PyBool_FromLong(op == Py_LT ? a < b : a > b);
+        }
+        return PyObject_RichCompare(when, other_when, op);
+    }
+    if (op == Py_LE || op == Py_GE) {
+        int ok = PyObject_RichCompareBool(when, other_when, op == Py_LE ? Py_LT : Py_GT);
+        if (ok < 0) {
+            return NULL;
+        }
+        if (ok) {
+            Py_RETURN_TRUE;
+        }
+        op = Py_EQ;
+    }
+    // Py_EQ / Py_NE
+    HandleObj *a = (HandleObj *)self, *b = (HandleObj *)other;
+    int eq = PyObject_RichCompareBool(when, other_when, Py_EQ);
+    if (eq > 0) {
+        eq = PyObject_RichCompareBool(a->h_callback ? a->h_callback : Py_None,
+                                      b->h_callback ? b->h_callback : Py_None,
+                                      Py_EQ);
+    }
+    if (eq > 0) {
+        eq = PyObject_RichCompareBool(a->h_args ? a->h_args : Py_None,
+                                      b->h_args ? b->h_args : Py_None,
+                                      Py_EQ);
+    }
+    if (eq > 0) {
+        eq = a->h_cancelled == b->h_cancelled;
+    }
+    if (eq < 0) {
+        return NULL;
+    }
+    return PyBool_FromLong(op == Py_NE ? !eq : eq);
+}
+
+static PyObject *
+TimerHandleObj_cancel(TimerHandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    _Py_IDENTIFIER(_timer_handle_cancelled);
+    if (!self->th_base.h_cancelled) {
+        PyObject *res = _PyObject_CallMethodIdObjArgs(
+            self->th_base.h_loop, &PyId__timer_handle_cancelled, self, NULL);
+        if (res == NULL) {
+            return NULL;
+        }
+        Py_DECREF(res);
+    }
+    return handle_cancel((HandleObj *)self);
+}
+
+static PyObject *
+TimerHandleObj_when(TimerHandleObj *self, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *when = self->th_when ? self->th_when : Py_None;
+    Py_INCREF(when);
+    return when;
+}
+
+static PyObject *
+TimerHandleObj_get_scheduled(TimerHandleObj *self, void *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(self->th_scheduled);
+}
+
+static int
+TimerHandleObj_set_scheduled(TimerHandleObj *self, PyObject *val, void *Py_UNUSED(ignored))
+{
+    if (val == NULL) {
+        PyErr_SetString(PyExc_AttributeError, "cannot delete attribute");
+        return -1;
+    }
+    int is_true = PyObject_IsTrue(val);
+    if (is_true < 0) {
+        return -1;
+    }
+    self->th_scheduled = is_true;
+    return 0;
+}
+
+static PyMethodDef TimerHandleType_methods[] = {
+    {"cancel", (PyCFunction)TimerHandleObj_cancel, METH_NOARGS, NULL},
+    {"when", (PyCFunction)TimerHandleObj_when, METH_NOARGS,
+     "Return a scheduled callback time.\n\n"
+     "The time is an absolute timestamp, using the same time\n"
+     "reference as loop.time()."},
+    {"_repr_info", (PyCFunction)TimerHandleObj_repr_info, METH_NOARGS, NULL},
+    {NULL, NULL}        /* Sentinel */
+};
+
+static PyMemberDef TimerHandleType_members[] = {
+    {"_when", T_OBJECT, offsetof(TimerHandleObj, th_when), 0},
+    {NULL}  /* Sentinel */
+};
+
+static PyGetSetDef TimerHandleType_getsetlist[] = {
+    {"_scheduled", (getter)TimerHandleObj_get_scheduled, (setter)TimerHandleObj_set_scheduled, NULL},
+    {NULL} /* Sentinel */
+};
+
+static PyTypeObject TimerHandleType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_asyncio.TimerHandle",
+    sizeof(TimerHandleObj),                  /* tp_basicsize */
+    .tp_base = &HandleType,
+    .tp_dealloc = (destructor)TimerHandleObj_dealloc,
+    .tp_hash = (hashfunc)TimerHandleObj_hash,
+    .tp_doc = "Object returned by timed callback registration methods.",
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_BASETYPE,
+    .tp_traverse = (traverseproc)TimerHandleObj_traverse,
+    .tp_clear = (inquiry)TimerHandleObj_clear,
+    .tp_richcompare = (richcmpfunc)TimerHandleObj_richcompare,
+    .tp_methods = TimerHandleType_methods,
+    .tp_members = TimerHandleType_members,
+    .tp_getset = TimerHandleType_getsetlist,
+    .tp_init = (initproc)TimerHandleObj_init,
+};
+
+/* ----- ReadyQueue */
+
+#define READY_QUEUE_MIN_CAPACITY 64
+
+static inline PyObject **
+readyqueue_slot(ReadyQueueObj *q, Py_ssize_t i)
+{
+    return &q->rq_items[(q->rq_head + i) & (q->rq_capacity - 1)];
+}
+
+static int
+readyqueue_append(ReadyQueueObj *q, PyObject *item)
+{
+    if (q->rq_len == q->rq_capacity) {
+        Py_ssize_t capacity = q->rq_capacity ? q->rq_capacity * 2
+                                             : READY_QUEUE_MIN_CAPACITY;
+        PyObject **items = PyMem_New(PyObject *, capacity);
+        if (items == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        for (Py_ssize_t i = 0; i < q->rq_len; i++) {
+            items[i] = *readyqueue_slot(q, i);
+        }
+        PyMem_Free(q->rq_items);
+        q->rq_items = items;
+        q->rq_head = 0;
+        q->rq_capacity = capacity;
+    }
+    Py_INCREF(item);
+    *readyqueue_slot(q, q->rq_len) = item;
+    q->rq_len++;
+    return 0;
+}
+
+// Returns a new reference or NULL if queue is empty (no error is set)
+static PyObject *
+readyqueue_popleft(ReadyQueueObj *q)
+{
+    if (q->rq_len == 0) {
+        return NULL;
+    }
+    PyObject *item = q->rq_items[q->rq_head];
+    q->rq_items[q->rq_head] = NULL;
+    q->rq_head = (q->rq_head + 1) & (q->rq_capacity - 1);
+    q->rq_len--;
+    return item;
+}
+
+static PyObject *
+ReadyQueueObj_tp_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    if (!_PyArg_NoPositional("ReadyQueue", args) ||
+        !_PyArg_NoKeywords("ReadyQueue", kwds)) {
+        return NULL;
+    }
+    ReadyQueueObj *q = (ReadyQueueObj *)type->tp_alloc(type, 0);
+    if (q == NULL) {
+        return NULL;
+    }
+    q->rq_items = NULL;
+    q->rq_head = q->rq_len = q->rq_capacity = 0;
+    return (PyObject *)q;
+}
+
+static int
+ReadyQueueObj_clear(ReadyQueueObj *q)
+{
+    PyObject *item;
+    // items are released one by one since their destructors can
+    // touch the queue
+    while ((item = readyqueue_popleft(q)) != NULL) {
+        Py_DECREF(item);
+    }
+    return 0;
+}
+
+static int
+ReadyQueueObj_traverse(ReadyQueueObj *q, visitproc visit, void *arg)
+{
+    for (Py_ssize_t i = 0; i < q->rq_len; i++) {
+        Py_VISIT(*readyqueue_slot(q, i));
+    }
+    return 0;
+}
+
+static void
+ReadyQueueObj_dealloc(ReadyQueueObj *q)
+{
+    PyObject_GC_UnTrack(q);
+    (void)ReadyQueueObj_clear(q);
+    PyMem_Free(q->rq_items);
+    Py_TYPE(q)->tp_free(q);
+}
+
+static PyObject *
+ReadyQueueObj_append(ReadyQueueObj *q, PyObject *item)
+{
+    if (readyqueue_append(q, item) < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+ReadyQueueObj_popleft(ReadyQueueObj *q, PyObject *Py_UNUSED(ignored))
+{
+    PyObject *item = readyqueue_popleft(q);
+    if (item == NULL) {
+        PyErr_SetString(PyExc_IndexError, "pop from an empty ReadyQueue");
+    }
+    return item;
+}
+
+static PyObject *
+ReadyQueueObj_clear_meth(ReadyQueueObj *q, PyObject *Py_UNUSED(ignored))
+{
+    (void)ReadyQueueObj_clear(q);
+    Py_RETURN_NONE;
+}
+
+/* _run(ntodo) - pops up to ntodo handles and runs the ones that were not
+   cancelled. This is the callback loop of BaseEventLoop._run_once when loop
+   is not in debug mode. */
+static PyObject *
+ReadyQueueObj_run(ReadyQueueObj *q, PyObject *arg)
+{
+    _Py_IDENTIFIER(_run);
+    _Py_IDENTIFIER(_cancelled);
+    Py_ssize_t ntodo = PyLong_AsSsize_t(arg);
+    if (ntodo == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < ntodo; i++) {
+        PyObject *handle = readyqueue_popleft(q);
+        if (handle == NULL) {
+            break;
+        }
+        PyObject *res;
+        if (Handle_CheckExact(handle) || Py_TYPE(handle) == &TimerHandleType) {
+            if (((HandleObj *)handle)->h_cancelled) {
+                Py_DECREF(handle);
+                continue;
+            }
+            res = handle_run((HandleObj *)handle);
+        }
+        else {
+            PyObject *cancelled = _PyObject_GetAttrId(handle, &PyId__cancelled);
+            int is_cancelled = cancelled ? PyObject_IsTrue(cancelled) : -1;
+            Py_XDECREF(cancelled);
+            if (is_cancelled != 0) {
+                Py_DECREF(handle);
+                if (is_cancelled < 0) {
+                    return NULL;
+                }
+                continue;
+            }
+            res = _PyObject_CallMethodId(handle, &PyId__run, NULL);
+        }
+        Py_DECREF(handle);
+        if (res == NULL) {
+            return NULL;
+        }
+        Py_DECREF(res);
+    }
+    Py_RETURN_NONE;
+}
+
+static Py_ssize_t
+ReadyQueueObj_len(ReadyQueueObj *q)
+{
+    return q->rq_len;
+}
+
+static PyObject *
+ReadyQueueObj_item(ReadyQueueObj *q, Py_ssize_t i)
+{
+    if (i < 0 || i >= q->rq_len) {
+        PyErr_SetString(PyExc_IndexError, "ReadyQueue index out of range");
+        return NULL;
+    }
+    PyObject *item = *readyqueue_slot(q, i);
+    Py_INCREF(item);
+    return item;
+}
+
+static int
+ReadyQueueObj_contains(ReadyQueueObj *q, PyObject *value)
+{
+    for (Py_ssize_t i = 0; i < q->rq_len; i++) {
+        PyObject *item = *readyqueue_slot(q, i);
+        Py_INCREF(item);
+        int cmp = PyObject_RichCompareBool(item, value, Py_EQ);
+        Py_DECREF(item);
+        if (cmp != 0) {
+            return cmp;
+        }
+    }
+    return 0;
+}
+
+static PyObject *
+ReadyQueueObj_iter(ReadyQueueObj *q)
+{
+    // iterate over a snapshot - handles are free to schedule more handles
+    PyObject *items = PyList_New(q->rq_len);
+    if (items == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < q->rq_len; i++) {
+        PyObject *item = *readyqueue_slot(q, i);
+        Py_INCREF(item);
+        PyList_SET_ITEM(items, i, item);
+    }
+    PyObject *it = PyObject_GetIter(items);
+    Py_DECREF(items);
+    return it;
+}
+
+static PySequenceMethods ReadyQueueType_as_sequence = {
+    .sq_length = (lenfunc)ReadyQueueObj_len,
+    .sq_item = (ssizeargfunc)ReadyQueueObj_item,
+    .sq_contains = (objobjproc)ReadyQueueObj_contains,
+};
+
+static PyMethodDef ReadyQueueType_methods[] = {
+    {"append", (PyCFunction)ReadyQueueObj_append, METH_O, NULL},
+    {"popleft", (PyCFunction)ReadyQueueObj_popleft, METH_NOARGS, NULL},
+    {"clear", (PyCFunction)ReadyQueueObj_clear_meth, METH_NOARGS, NULL},
+    {"_run", (PyCFunction)ReadyQueueObj_run, METH_O, NULL},
+    {NULL, NULL}        /* Sentinel */
+};
+
+static PyTypeObject ReadyQueueType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_asyncio.ReadyQueue",
+    sizeof(ReadyQueueObj),                   /* tp_basicsize */
+    .tp_dealloc = (destructor)ReadyQueueObj_dealloc,
+    .tp_as_sequence = &ReadyQueueType_as_sequence,
+    .tp_doc = "FIFO queue of handles ready to run.",
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_traverse = (traverseproc)ReadyQueueObj_traverse,
+    .tp_clear = (inquiry)ReadyQueueObj_clear,
+    .tp_iter = (getiterfunc)ReadyQueueObj_iter,
+    .tp_methods = ReadyQueueType_methods,
+    .tp_new = ReadyQueueObj_tp_new,
+};
+
+
 struct PyEventLoopDispatchTable;
 
 typedef PyObject* (*invoke_get_debug_f)(
@@ -1328,6 +2302,103 @@ invoke_call_soon(
     return res;
 }
 
+static int
+loop_get_flag(PyObject *loop, _Py_Identifier *name)
+{
+    PyObject *val = _PyObject_GetAttrId(loop, name);
+    if (val == NULL) {
+        return -1;
+    }
+    int res = PyObject_IsTrue(val);
+    Py_DECREF(val);
+    return res;
+}
+
+// call_soon for loops that use BaseEventLoop.call_soon - outside of debug
+// mode appends a handle to the loop's ready queue without calling
+// into Python
+static PyObject*
+invoke_call_soon_ready_queue(
+    PyEventLoopDispatchTable *table,
+    PyObject *loop,
+    PyObject *func,
+    PyObject *arg,
+    PyObject *ctx
+)
+{
+    PyObject *ready = _PyObject_GetAttrId(loop, &PyId__ready);
+    if (ready == NULL) {
+        return NULL;
+    }
+    int slow_path = !ReadyQueue_CheckExact(ready);
+    if (!slow_path) {
+        slow_path = loop_get_flag(loop, &PyId__closed);
+    }
+    if (slow_path == 0) {
+        slow_path = loop_get_flag(loop, &PyId__debug);
+    }
+    if (slow_path != 0) {
+        Py_DECREF(ready);
+        if (slow_path < 0) {
+            return NULL;
+        }
+        // let Python version do the checks and report errors
+        return invoke_call_soon_vectorcall(table, loop, func, arg, ctx);
+    }
+    PyObject *args = arg == NULL ? PyTuple_New(0) : PyTuple_Pack(1, arg);
+    if (args == NULL) {
+        Py_DECREF(ready);
+        return NULL;
+    }
+    PyObject *handle = handle_new(func, args, loop, ctx);
+    Py_DECREF(args);
+    if (handle == NULL ||
+        readyqueue_append((ReadyQueueObj *)ready, handle) < 0) {
+        Py_XDECREF(handle);
+        Py_DECREF(ready);
+        return NULL;
+    }
+    Py_DECREF(ready);
+    return handle;
+}
+
+// BaseEventLoop.call_soon and BaseEventLoop._call_soon - loops that don't
+// override them get invoke_call_soon_ready_queue
+static PyObject *base_event_loop_call_soon;
+static PyObject *base_event_loop__call_soon;
+
+static int
+uses_base_event_loop_call_soon(PyTypeObject *type)
+{
+    if (base_event_loop_call_soon == NULL) {
+        PyObject *module = PyImport_ImportModule("asyncio.base_events");
+        if (module == NULL) {
+            return -1;
+        }
+        PyObject *cls = PyObject_GetAttrString(module, "BaseEventLoop");
+        Py_DECREF(module);
+        if (cls == NULL) {
+            return -1;
+        }
+        if (!PyType_Check(cls)) {
+            Py_DECREF(cls);
+            return 0;
+        }
+        PyObject *call_soon = _PyType_LookupId((PyTypeObject *)cls, &PyId_call_soon);
+        PyObject *_call_soon = _PyType_LookupId((PyTypeObject *)cls, &PyId__call_soon);
+        Py_DECREF(cls);
+        if (call_soon == NULL || _call_soon == NULL) {
+            return 0;
+        }
+        Py_INCREF(call_soon);
+        base_event_loop_call_soon = call_soon;
+        Py_INCREF(_call_soon);
+        base_event_loop__call_soon = _call_soon;
+    }
+    return _PyType_LookupId(type, &PyId_call_soon) == base_event_loop_call_soon &&
+           _PyType_LookupId(type, &PyId__call_soon) == base_event_loop__call_soon;
+}
+
 static int
 event_loop_dispatch_table_traverse(
     PyEventLoopDispatchTable *obj, visitproc visit, void *arg
@@ -1450,6 +2521,15 @@ get_dispatch_table(PyTypeObject *type)
                 Py_INCREF(call_soon);
                 table->invoke_call_soon = invoke_call_soon_vectorcall;
                 table->call_soon_method = NULL;
+
+                int ok = uses_base_event_loop_call_soon(type);
+                if (ok < 0) {
+                    // asyncio.base_events is not importable yet
+                    PyErr_Clear();
+                }
+                else if (ok) {
+                    table->invoke_call_soon = invoke_call_soon_ready_queue;
+                }
             }
         }
         PyObject *get_debug = _PyType_LookupId(type, &PyId_get_debug);
@@ -6766,6 +7846,41 @@ _wrap_result_value(PyObject *result, PyObject *loop, int awaited)
     return fut;
 }
 
+// Moves currently raised exception into a new future created on 'loop':
+// CancelledError cancels the future, other Exceptions are set on it.
+// Anything else (i.e. KeyboardInterrupt) is left raised.
+static PyObject *
+_wrap_error_in_future(PyObject *loop)
+{
+    assert(PyErr_Occurred());
+    int cancelled = PyErr_ExceptionMatches(asyncio_CancelledError);
+    if (!cancelled && !PyErr_ExceptionMatches(PyExc_Exception)) {
+        return NULL;
+    }
+    PyObject *et, *ev, *tb;
+    PyErr_Fetch(&et, &ev, &tb);
+    PyErr_NormalizeException(&et, &ev, &tb);
+    if (tb != NULL) {
+        PyException_SetTraceback(ev, tb);
+    }
+    PyObject *fut = _create_future(loop);
+    PyObject *res = NULL;
+    if (fut != NULL) {
+        res = cancelled ? _PyObject_CallMethodId(fut, &PyId_cancel, NULL)
+                        : _PyObject_CallMethodIdObjArgs(
+                              fut, &PyId_set_exception, ev, NULL);
+    }
+    Py_DECREF(et);
+    Py_XDECREF(ev);
+    Py_XDECREF(tb);
+    if (res == NULL) {
+        Py_XDECREF(fut);
+        return NULL;
+    }
+    Py_DECREF(res);
+    return fut;
+}
+
 #define USE_RESULT_ERROR -1
 #define USE_RESULT_FOUND 0
 #define USE_RESULT_NOT_FOUND 1
@@ -6804,7 +7919,7 @@ _try_use_result_for_existing_coro(PyThreadState *tstate,
         if (index == -1) {
             return USE_RESULT_ERROR;
         }
-        val = PyList_GET_ITEM(data, i);
+        val = PyList_GET_ITEM(data, index);
     } else {
         assert(datamap != NULL);
         _Bitset_set(datamap, i);
@@ -6952,7 +8067,8 @@ _gather_multiple(PyObject *const*items,
                  PyObject *arg_to_fut,
                  PyObject *loop,
                  int return_exceptions,
-                 int awaited)
+                 int awaited,
+                 int eager)
 {
     int release_loop = 0;
 
@@ -7030,8 +8146,8 @@ _gather_multiple(PyObject *const*items,
             continue;
         }
         PyObject *fut;
-        if (awaited && kind == KIND_COROUTINE) {
-            // when awaited - try to execute coroutine eagerly
+        if ((awaited || eager) && kind == KIND_COROUTINE) {
+            // when awaited or asked to - try to execute coroutine eagerly
             if (current_context == NULL) {
                 int context_aware_task;
                 if (get_current_context_and_task(tstate,
@@ -7229,7 +8345,8 @@ _gather_worker(PyObject *const*items,
                PyObject *loop,
                int return_exceptions,
                int assume_no_duplicates,
-               int awaited)
+               int awaited,
+               int eager)
 {
     if (nitems == 0) {
         PyObject *result = PyList_New(0);
@@ -7248,7 +8365,7 @@ _gather_worker(PyObject *const*items,
         }
     }
     PyObject *result = _gather_multiple(
-        items, nitems, arg_to_fut, loop, return_exceptions, awaited);
+        items, nitems, arg_to_fut, loop, return_exceptions, awaited, eager);
     Py_XDECREF(arg_to_fut);
     return result;
 }
@@ -7257,7 +8374,8 @@ static PyObject *
 _asyncio_gather_impl(PyObject *const*args,
                      size_t nargsf,
                      PyObject *kwnames,
-                     int assume_no_duplicates)
+                     int assume_no_duplicates,
+                     int eager)
 {
     static const char * const _keywords[] = {"loop", "return_exceptions", NULL};
     static _PyArg_Parser _parser = {NULL, _keywords, "gather", 0};
@@ -7296,12 +8414,21 @@ _asyncio_gather_impl(PyObject *const*args,
         default:
             Py_UNREACHABLE();
     }
-    return _gather_worker(args,
-                          nargs,
-                          loop,
-                          return_exceptions,
-                          assume_no_duplicates,
-                          _Py_AWAITED_CALL(nargsf) != 0);}
+    int awaited = _Py_AWAITED_CALL(nargsf) != 0;
+    PyObject *res = _gather_worker(args,
+                                   nargs,
+                                   loop,
+                                   return_exceptions,
+                                   assume_no_duplicates,
+                                   awaited,
+                                   eager);
+    if (res == NULL && eager && !awaited) {
+        // caller expects a future - report errors raised by children
+        // while running eagerly through it
+        return _wrap_error_in_future(loop);
+    }
+    return res;
+}
 
 static PyObject *
 _asyncio_gather(PyObject *Py_UNUSED(module),
@@ -7309,7 +8436,20 @@ _asyncio_gather(PyObject *Py_UNUSED(module),
                 size_t nargsf,
                 PyObject *kwnames)
 {
-    return _asyncio_gather_impl(args, nargsf, kwnames, 0);
+    return _asyncio_gather_impl(args, nargsf, kwnames, 0, 0);
+}
+
+// Same as gather but runs coroutine arguments eagerly up to their first
+// suspension even when the call is not awaited. If every child completes
+// synchronously returns a completed future and nothing is scheduled
+// on the loop.
+static PyObject *
+_asyncio_eager_gather(PyObject *Py_UNUSED(module),
+                      PyObject **args,
+                      size_t nargsf,
+                      PyObject *kwnames)
+{
+    return _asyncio_gather_impl(args, nargsf, kwnames, 0, 1);
 }
 
 static PyObject *
@@ -7318,13 +8458,13 @@ _asyncio_ig_gather(PyObject *Py_UNUSED(module),
                    size_t nargsf,
                    PyObject *kwnames)
 {
-    return _asyncio_gather_impl(args, nargsf, kwnames, 1);
+    return _asyncio_gather_impl(args, nargsf, kwnames, 1, 0);
 }
 
 static PyObject *
 _asyncio_ig_gather_raise(PyObject *module, PyObject **args, size_t nargsf)
 {
-    return _gather_worker(args, PyVectorcall_NARGS(nargsf), Py_None, 0, 1, _Py_AWAITED_CALL(nargsf) != 0);
+    return _gather_worker(args, PyVectorcall_NARGS(nargsf), Py_None, 0, 1, _Py_AWAITED_CALL(nargsf) != 0, 0);
 }
 
 static PyObject *
@@ -7359,7 +8499,7 @@ _asyncio_ig_gather_iterable_impl(PyObject **args,
         nitems = PyTuple_GET_SIZE(iterable);
     }
     PyObject *result =
-        _gather_worker(items, nitems, Py_None, return_exceptions, 1, _Py_AWAITED_CALL(nargsf) != 0);
+        _gather_worker(items, nitems, Py_None, return_exceptions, 1, _Py_AWAITED_CALL(nargsf) != 0, 0);
     if (iterable != args[0]) {
         Py_DECREF(iterable);
     }
@@ -7406,7 +8546,7 @@ _asyncio_ig_gather_no_raise(PyObject *module,
                             PyObject **args,
                             size_t nargsf)
 {
-    return _gather_worker(args, PyVectorcall_NARGS(nargsf), Py_None, 1, 1, _Py_AWAITED_CALL(nargsf) != 0);
+    return _gather_worker(args, PyVectorcall_NARGS(nargsf), Py_None, 1, 1, _Py_AWAITED_CALL(nargsf) != 0, 0);
 }
 
 /*[clinic input]
@@ -7790,6 +8930,70 @@ _start_immediate_impl(PyObject *coro, PyObject *loop)
     return res;
 }
 
+// eager_create_task(coro, loop=None, /)
+// Runs 'coro' eagerly up to its first suspension. If it completes
+// synchronously - returns a completed future with its result or exception
+// without scheduling anything on the loop, otherwise returns a task that
+// drives the rest of the coroutine.
+static PyObject *
+_asyncio_eager_create_task(PyObject *Py_UNUSED(module),
+                           PyObject *const *args,
+                           Py_ssize_t nargs)
+{
+    if (!_PyArg_CheckPositional("eager_create_task", nargs, 1, 2)) {
+        return NULL;
+    }
+    PyObject *coro = args[0];
+    PyObject *loop = nargs > 1 ? args[1] : Py_None;
+    CORO_OR_FUTURE_KIND kind = _get_coro_or_future_kind(coro);
+    if (kind == KIND_ERROR) {
+        return NULL;
+    }
+    if (kind != KIND_COROUTINE) {
+        PyErr_Format(PyExc_TypeError, "a coroutine was expected, got %R", coro);
+        return NULL;
+    }
+    int release_loop = 0;
+    if (loop == Py_None) {
+        if (get_running_loop(&loop) < 0) {
+            return NULL;
+        }
+        if (loop == NULL) {
+            PyErr_SetString(PyExc_RuntimeError, "no running event loop");
+            return NULL;
+        }
+        release_loop = 1;
+    }
+
+    PyThreadState *tstate = PyThreadState_GET();
+    PyObject *retval = NULL, *ctx, *task;
+    int context_aware_task;
+    if (get_current_context_and_task(tstate, &ctx, &task, &context_aware_task) < 0) {
+        goto done;
+    }
+    context_aware_task_set_ctx_f context_setter = context_aware_task ? _context_aware_task_set_ctx : NULL;
+    int finished = 0;
+    PyObject *res = _start_coroutine_helper(tstate, coro, loop, &finished);
+    if (call_reset_context(tstate, task, ctx, context_setter, res == NULL) < 0) {
+        Py_CLEAR(res);
+    }
+    Py_DECREF(ctx);
+    if (!finished) {
+        // either a task wrapping suspended coroutine or an error
+        retval = res;
+    } else if (res == NULL) {
+        retval = _wrap_error_in_future(loop);
+    } else {
+        retval = _wrap_result_value(res, loop, 0);
+        Py_DECREF(res);
+    }
+done:
+    if (release_loop) {
+        Py_DECREF(loop);
+    }
+    return retval;
+}
+
 /*********************** PyRunningLoopHolder ********************/
 
 
@@ -7851,6 +9055,18 @@ module_free_freelists(void)
     }
     assert(fi_freelist_len == 0);
     fi_freelist = NULL;
+
+    next = (PyObject*) handle_freelist;
+    while (next != NULL) {
+        assert(handle_freelist_len > 0);
+        handle_freelist_len--;
+
+        current = next;
+        next = ((HandleObj*) current)->h_callback;
+        PyObject_GC_Del(current);
+    }
+    assert(handle_freelist_len == 0);
+    handle_freelist = NULL;
 }
 
 
@@ -7865,6 +9081,8 @@ module_free(void *m)
     Py_CLEAR(asyncio_task_get_stack_func);
     Py_CLEAR(asyncio_task_print_stack_func);
     Py_CLEAR(asyncio_task_repr_info_func);
+    Py_CLEAR(asyncio_extract_stack_func);
+    Py_CLEAR(asyncio_format_callback_source_func);
     Py_CLEAR(asyncio_InvalidStateError);
     Py_CLEAR(asyncio_CancelledError);
 
@@ -7886,6 +9104,8 @@ module_free(void *m)
     Py_CLEAR(last_used_eventloop_type);
     Py_CLEAR(last_used_eventloop_dispatch_table);
     Py_CLEAR(fallback_dispatch_table);
+    Py_CLEAR(base_event_loop_call_soon);
+    Py_CLEAR(base_event_loop__call_soon);
     Py_CLEAR(context_aware_task_hooks);
     Py_CLEAR(known_coroutine_types);
     Py_CLEAR(awaitable_types_cache);
@@ -7970,6 +9190,10 @@ module_init(void)
     WITH_MOD("asyncio.events")
     GET_MOD_ATTR(asyncio_get_event_loop_policy, "get_event_loop_policy")
 
+    WITH_MOD("asyncio.format_helpers")
+    GET_MOD_ATTR(asyncio_extract_stack_func, "extract_stack")
+    GET_MOD_ATTR(asyncio_format_callback_source_func, "_format_callback_source")
+
     WITH_MOD("asyncio.base_futures")
     GET_MOD_ATTR(asyncio_future_repr_info_func, "_future_repr_info")
 
@@ -8033,6 +9257,8 @@ static PyMethodDef asyncio_methods[] = {
     _ASYNCIO__SET_CONTEXT_HELPERS_METHODDEF
     _ASYNCIO__RESET_CONTEXT_HELPERS_METHODDEF
     { "gather", (PyCFunction)_asyncio_gather, METH_FASTCALL | METH_KEYWORDS, NULL },
+    { "eager_gather", (PyCFunction)_asyncio_eager_gather, METH_FASTCALL | METH_KEYWORDS, NULL },
+    { "eager_create_task", (PyCFunction)_asyncio_eager_create_task, METH_FASTCALL, NULL },
 
     // IG specific bits
     { "ig_gather", (PyCFunction)_asyncio_ig_gather, METH_FASTCALL | METH_KEYWORDS, NULL },
@@ -8127,6 +9353,15 @@ PyInit__asyncio(void)
     if (PyType_Ready(&TaskType) < 0) {
         return NULL;
     }
+    if (PyType_Ready(&HandleType) < 0) {
+        return NULL;
+    }
+    if (PyType_Ready(&TimerHandleType) < 0) {
+        return NULL;
+    }
+    if (PyType_Ready(&ReadyQueueType) < 0) {
+        return NULL;
+    }
     if (PyType_Ready(&PyRunningLoopHolder_Type) < 0) {
         return NULL;
     }
@@ -8239,6 +9474,27 @@ PyInit__asyncio(void)
         return NULL;
     }
 
+    Py_INCREF(&HandleType);
+    if (PyModule_AddObject(m, "Handle", (PyObject *)&HandleType) < 0) {
+        Py_DECREF(&HandleType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&TimerHandleType);
+    if (PyModule_AddObject(m, "TimerHandle", (PyObject *)&TimerHandleType) < 0) {
+        Py_DECREF(&TimerHandleType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&ReadyQueueType);
+    if (PyModule_AddObject(m, "ReadyQueue", (PyObject *)&ReadyQueueType) < 0) {
+        Py_DECREF(&ReadyQueueType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
     Py_INCREF(&ContextAwareTaskType);
     if (PyModule_AddObject(
             m, "ContextAwareTask", (PyObject *)&ContextAwareTaskType) < 0) {
@@ -335,12 +335,20 @@ tracemalloc_get_frame(PyFrameObject *pyframe, frame_t *frame)
     int lineno;
 
     frame->filename = unknown_filename;
-    lineno = PyFrame_GetLineNumber(pyframe);
+    if (JIT_IsTinyFrame(pyframe)) {
+        /* Don't materialize the frame of a JIT-compiled function: it would
+           reenter the memory allocator. */
+        code = ((TinyFrame *)pyframe)->code;
+        lineno = code != NULL ? code->co_firstlineno : 0;
+    }
+    else {
+        code = pyframe->f_code;
+        lineno = PyFrame_GetLineNumber(pyframe);
+    }
     if (lineno < 0)
         lineno = 0;
     frame->lineno = (unsigned int)lineno;
 
-    code = pyframe->f_code;
     if (code == NULL) {
 #ifdef TRACE_DEBUG
         tracemalloc_error("failed to get the code object of the frame");
@@ -437,7 +445,9 @@ traceback_get_frames(traceback_t *traceback)
         return;
     }
 
-    for (pyframe = tstate->frame; pyframe != NULL; pyframe = pyframe->f_back) {
+    for (pyframe = tstate->frame; pyframe != NULL;
+         pyframe = JIT_IsTinyFrame(pyframe) ? ((TinyFrame *)pyframe)->t.f_back
+                                            : pyframe->f_back) {
         tracemalloc_get_frame(pyframe, &traceback->frames[traceback->nframe]);
         assert(traceback->frames[traceback->nframe].filename != NULL);
         traceback->nframe++;
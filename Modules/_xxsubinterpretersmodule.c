@@ -6,6 +6,8 @@
 #include "frameobject.h"
 #include "interpreteridobject.h"
 
+#include "Jit/frame.h"
+
 
 static char *
 _copy_raw_string(PyObject *strobj)
@@ -1837,6 +1839,10 @@ _is_running(PyInterpreterState *interp)
         }
         return 0;
     }
+    if (JIT_IsTinyFrame(frame)) {
+        /* Tiny frames only exist while their function is running. */
+        return 1;
+    }
     return (int)(frame->f_executing);
 }
 
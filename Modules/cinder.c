@@ -2,8 +2,12 @@
 #include "Python.h"
 
 PyAPI_FUNC(void) _PyShadow_ClearCache(PyObject *co);
+PyAPI_FUNC(PyObject *) _PyShadow_GetCacheMemoryStats(void);
+PyAPI_FUNC(Py_ssize_t) _PyShadow_CompactCaches(void);
+PyAPI_FUNC(PyObject *) _PyJIT_GetCacheMemoryStats(void);
 
 extern int _PyShadow_PolymorphicCacheEnabled;
+extern int _PyShadow_CacheCompactionEnabled;
 extern int _Py_SkipFinalCleanup;
 extern int _Py_SetShortcutTypeCall;
 
@@ -37,6 +41,24 @@ cinder_setknobs(PyObject *self, PyObject *o)
         _PyShadow_PolymorphicCacheEnabled = enabled != -1 && enabled;
     }
 
+    PyObject *compaction = PyDict_GetItemString(o, "shadowcachecompaction");
+    if (compaction != NULL) {
+        int enabled = PyObject_IsTrue(compaction);
+        _PyShadow_CacheCompactionEnabled = enabled != -1 && enabled;
+    }
+
+    PyObject *gil_fifo = PyDict_GetItemString(o, "gilfifo");
+    if (gil_fifo != NULL) {
+        int enabled = PyObject_IsTrue(gil_fifo);
+        _PyEval_SetGILFifo(enabled != -1 && enabled);
+    }
+
+    PyObject *gil_stats = PyDict_GetItemString(o, "gilstats");
+    if (gil_stats != NULL) {
+        int enabled = PyObject_IsTrue(gil_stats);
+        _PyEval_SetGILStatsEnabled(enabled != -1 && enabled);
+    }
+
     PyObject *skip_final_cleanup = PyDict_GetItemString(o, "skipfinalcleanup");
     if (skip_final_cleanup) {
         int skip_cleanup = PyObject_IsTrue(skip_final_cleanup);
@@ -96,6 +118,26 @@ cinder_getknobs(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    err = PyDict_SetItemString(res,
+                               "shadowcachecompaction",
+                               _PyShadow_CacheCompactionEnabled ? Py_True
+                                                                : Py_False);
+    if (err == -1) {
+        return NULL;
+    }
+
+    err = PyDict_SetItemString(
+        res, "gilfifo", _PyEval_GetGILFifo() ? Py_True : Py_False);
+    if (err == -1) {
+        return NULL;
+    }
+
+    err = PyDict_SetItemString(
+        res, "gilstats", _PyEval_GetGILStatsEnabled() ? Py_True : Py_False);
+    if (err == -1) {
+        return NULL;
+    }
+
     return res;
 }
 
@@ -210,6 +252,79 @@ clear_shadow_cache(PyObject *self, PyObject *obj)
     Py_RETURN_NONE;
 }
 
+static PyObject *
+get_cache_memory_stats(PyObject *self, PyObject *obj)
+{
+    PyObject *res = PyDict_New();
+    if (res == NULL) {
+        return NULL;
+    }
+    PyObject *shadow = _PyShadow_GetCacheMemoryStats();
+    if (shadow == NULL || PyDict_SetItemString(res, "shadow", shadow) < 0) {
+        Py_XDECREF(shadow);
+        Py_DECREF(res);
+        return NULL;
+    }
+    Py_DECREF(shadow);
+    PyObject *jit = _PyJIT_GetCacheMemoryStats();
+    if (jit == NULL || PyDict_SetItemString(res, "jit", jit) < 0) {
+        Py_XDECREF(jit);
+        Py_DECREF(res);
+        return NULL;
+    }
+    Py_DECREF(jit);
+    return res;
+}
+
+PyDoc_STRVAR(get_cache_memory_stats_doc,
+"get_cache_memory_stats()\n\
+\n\
+Returns the bytes used by the shadow code and JIT inline caches, as a dict\n\
+with a \"shadow\" and a \"jit\" dict mapping the kind of cache to bytes.");
+
+static PyObject *
+compact_caches(PyObject *self, PyObject *obj)
+{
+    return PyLong_FromSsize_t(_PyShadow_CompactCaches());
+}
+
+PyDoc_STRVAR(compact_caches_doc,
+"compact_caches()\n\
+\n\
+Frees the shadow code and caches of code objects which haven't run since\n\
+the previous compaction, and returns how many were freed.  With the\n\
+shadowcachecompaction knob set this also runs on every full collection.");
+
+static PyObject *
+get_gil_stats(PyObject *self, PyObject *obj)
+{
+    return _PyEval_GetGILStats();
+}
+
+PyDoc_STRVAR(get_gil_stats_doc,
+"get_gil_stats()\n\
+\n\
+Returns a dict of GIL statistics collected while the gilstats knob is set:\n\
+\"wait\" and \"hold\" are histograms of how long threads waited for and\n\
+held the GIL, where bucket 0 counts durations under a microsecond and\n\
+bucket i counts durations of [2**(i-1), 2**i) microseconds.\n\
+\"drop_requests\" counts requests for the holder to drop the GIL after a\n\
+waiter timed out, \"forced_switches\" counts releases of the GIL while\n\
+such a request was pending, and \"switches\" is the total number of\n\
+switches between threads.");
+
+static PyObject *
+clear_gil_stats(PyObject *self, PyObject *obj)
+{
+    _PyEval_ResetGILStats();
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(clear_gil_stats_doc,
+"clear_gil_stats()\n\
+\n\
+Resets the histograms and counters returned by get_gil_stats().");
+
 
 PyDoc_STRVAR(strict_module_patch_doc,
 "strict_module_patch(mod, name, value)\n\
@@ -340,6 +455,13 @@ static struct PyMethodDef cinder_module_methods[] = {
      "Clears caches associated with the JIT.  This may have a negative effect "
      "on performance of existing JIT compiled code."},
     {"clear_shadow_cache", clear_shadow_cache, METH_O, ""},
+    {"get_cache_memory_stats",
+     get_cache_memory_stats,
+     METH_NOARGS,
+     get_cache_memory_stats_doc},
+    {"compact_caches", compact_caches, METH_NOARGS, compact_caches_doc},
+    {"get_gil_stats", get_gil_stats, METH_NOARGS, get_gil_stats_doc},
+    {"clear_gil_stats", clear_gil_stats, METH_NOARGS, clear_gil_stats_doc},
     {"strict_module_patch",
      strict_module_patch,
      METH_VARARGS,
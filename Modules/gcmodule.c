@@ -28,6 +28,7 @@
 #include "pycore_object.h"
 #include "pycore_pymem.h"
 #include "pycore_pystate.h"
+#include "pycore_shadowcode.h"
 #include "frameobject.h"        /* for PyFrame_ClearFreeList */
 #include "pydtrace.h"
 #include "pytime.h"             /* for _PyTime_GetMonotonicClock() */
@@ -1153,6 +1154,9 @@ collect(struct _gc_runtime_state *state, int generation,
      * generation */
     if (generation == NUM_GENERATIONS-1) {
         clear_freelists();
+        if (_PyShadow_CacheCompactionEnabled) {
+            (void)_PyShadow_CompactCaches();
+        }
     }
 
     if (PyErr_Occurred()) {
@@ -1856,6 +1860,63 @@ gc_is_immortal(PyObject *module, PyObject *obj)
     {"is_immortal", (PyCFunction)gc_is_immortal, METH_O, gc_is_immortal_heap__doc__},
 
 #endif
+
+PyDoc_STRVAR(gc_set_freeze_on_fork__doc__,
+"set_freeze_on_fork($module, enabled, /)\n"
+"--\n"
+"\n"
+"Freeze all tracked objects in children created by fork().\n"
+"\n"
+"Collections in the child then never write to the GC headers of objects\n"
+"inherited from the parent, so those pages stay shared. Unreachable\n"
+"cycles inherited from the parent are not collected in the child.");
+
+#define GC_SET_FREEZE_ON_FORK_METHODDEF    \
+    {"set_freeze_on_fork", (PyCFunction)gc_set_freeze_on_fork, METH_O, \
+     gc_set_freeze_on_fork__doc__},
+
+static PyObject *
+gc_set_freeze_on_fork(PyObject *module, PyObject *enabled)
+{
+    int flag = PyObject_IsTrue(enabled);
+    if (flag < 0) {
+        return NULL;
+    }
+    _PyRuntime.gc.freeze_on_fork = flag;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gc_get_freeze_on_fork__doc__,
+"get_freeze_on_fork($module, /)\n"
+"--\n"
+"\n"
+"Return True if children created by fork() freeze all tracked objects.");
+
+#define GC_GET_FREEZE_ON_FORK_METHODDEF    \
+    {"get_freeze_on_fork", (PyCFunction)gc_get_freeze_on_fork, METH_NOARGS, \
+     gc_get_freeze_on_fork__doc__},
+
+static PyObject *
+gc_get_freeze_on_fork(PyObject *module, PyObject *Py_UNUSED(ignored))
+{
+    return PyBool_FromLong(_PyRuntime.gc.freeze_on_fork);
+}
+
+/* Called in the child process after fork(). Merging the generations into
+ * the permanent one only writes to the list heads and to the headers of the
+ * objects at the list boundaries. */
+void
+_PyGC_AfterFork_Child(void)
+{
+    struct _gc_runtime_state *state = &_PyRuntime.gc;
+    if (!state->freeze_on_fork) {
+        return;
+    }
+    for (int i = 0; i < NUM_GENERATIONS; ++i) {
+        gc_list_merge(GEN_HEAD(state, i), &state->permanent_generation.head);
+        state->generations[i].count = 0;
+    }
+}
 /* facebook end */
 
 PyDoc_STRVAR(gc__doc__,
@@ -1880,7 +1941,9 @@ PyDoc_STRVAR(gc__doc__,
 #endif
 "freeze() -- Freeze all tracked objects and ignore them for future collections.\n"
 "unfreeze() -- Unfreeze all objects in the permanent generation.\n"
-"get_freeze_count() -- Return the number of objects in the permanent generation.\n");
+"get_freeze_count() -- Return the number of objects in the permanent generation.\n"
+"set_freeze_on_fork() -- Freeze all tracked objects in children created by fork().\n"
+"get_freeze_on_fork() -- Return True if children freeze all tracked objects.\n");
 
 static PyMethodDef GcMethods[] = {
     GC_ENABLE_METHODDEF
@@ -1908,6 +1971,8 @@ static PyMethodDef GcMethods[] = {
     GC_GET_FREEZE_COUNT_METHODDEF
     GC_GET_FROZEN_OBJECTS_METHODDEF
     GC_GET_ALL_REFERRERS_METHODDEF
+    GC_SET_FREEZE_ON_FORK_METHODDEF
+    GC_GET_FREEZE_ON_FORK_METHODDEF
     {NULL,      NULL}           /* Sentinel */
 };
 
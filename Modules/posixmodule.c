@@ -470,6 +470,7 @@ PyOS_AfterFork_Child(void)
     _PyImport_ReInitLock();
     _PySignal_AfterFork();
     _PyJIT_AfterFork_Child();
+    _PyGC_AfterFork_Child();
     _PyRuntimeState_ReInitThreads(runtime);
     _PyInterpreterState_DeleteExceptMain(runtime);
 
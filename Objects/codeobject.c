@@ -557,6 +557,8 @@ code_sizeof(PyCodeObject *co, PyObject *Py_UNUSED(args))
         res += sizeof(_PyShadow_InstanceAttrEntry **) *
                shadow->polymorphic_caches_size;
         res += sizeof(_FieldCache) * shadow->field_cache_size;
+        res += sizeof(_PyShadow_TypeCallCache) *
+               shadow->type_call_caches_size;
         res += sizeof(_Py_CODEUNIT) * shadow->len;
     }
     return PyLong_FromSsize_t(res);
@@ -53,7 +53,11 @@ struct method_cache_entry {
 };
 
 static struct method_cache_entry method_cache[1 << MCACHE_SIZE_EXP];
-static unsigned int next_version_tag = 0;
+/* Version tags are handed out in increasing order and never reused, so a
+   (nonzero) tag identifies one type in one state for the lifetime of the
+   process.  Caches outside of this file rely on this to validate an entry
+   with a single comparison against tp_version_tag. */
+static unsigned int next_version_tag = 1;
 
 
 static size_t method_cache_hits = 0;
@@ -282,9 +286,9 @@ PyType_ClearCache(void)
         Py_CLEAR(method_cache[i].name);
         method_cache[i].value = NULL;
     }
-    next_version_tag = 0;
 
     _PyClassLoader_ClearCache();
+    _PyShadow_ClearMegamorphicCache();
 
     /* mark all version tags as invalid */
     PyType_Modified(&PyBaseObject_Type);
@@ -464,6 +468,7 @@ type_mro_modified(PyTypeObject *type, PyObject *bases) {
     Py_XDECREF(type_mro_meth);
     type->tp_flags &= ~(Py_TPFLAGS_HAVE_VERSION_TAG|
                         Py_TPFLAGS_VALID_VERSION_TAG);
+    type->tp_version_tag = 0;
 }
 
 static int
@@ -484,36 +489,34 @@ assign_version_tag(PyTypeObject *type)
     if (!PyType_HasFeature(type, Py_TPFLAGS_READY))
         return 0;
 
-    type->tp_version_tag = next_version_tag++;
-    /* for stress-testing: next_version_tag &= 0xFF; */
-
-    if (type->tp_version_tag == 0) {
-        /* wrap-around or just starting Python - clear the whole
-           cache by filling names with references to Py_None.
-           Values are also set to NULL for added protection, as they
-           are borrowed reference */
-        for (i = 0; i < (1 << MCACHE_SIZE_EXP); i++) {
-            method_cache[i].value = NULL;
-            Py_INCREF(Py_None);
-            Py_XSETREF(method_cache[i].name, Py_None);
-        }
-        /* mark all version tags as invalid */
-        PyType_Modified(&PyBaseObject_Type);
+    if (next_version_tag == 0) {
+        /* Every tag has been handed out.  Rather than wrapping around and
+           reusing tags, which could revalidate stale cache entries, stop
+           assigning them: the type just won't be cached. */
         return 0;
     }
+    type->tp_version_tag = next_version_tag++;
     bases = type->tp_bases;
     n = PyTuple_GET_SIZE(bases);
     for (i = 0; i < n; i++) {
         PyObject *b = PyTuple_GET_ITEM(bases, i);
         assert(PyType_Check(b));
-        if (!assign_version_tag((PyTypeObject *)b))
+        if (!assign_version_tag((PyTypeObject *)b)) {
+            type->tp_version_tag = 0;
             return 0;
+        }
     }
     type->tp_flags |= Py_TPFLAGS_VALID_VERSION_TAG;
     return 1;
 }
 
 
+int
+_PyType_AssignVersionTag(PyTypeObject *type)
+{
+    return assign_version_tag(type);
+}
+
 static PyMemberDef type_members[] = {
     {"__basicsize__", T_PYSSIZET, offsetof(PyTypeObject,tp_basicsize),READONLY},
     {"__itemsize__", T_PYSSIZET, offsetof(PyTypeObject, tp_itemsize), READONLY},
@@ -3562,7 +3565,7 @@ _PyType_Lookup(PyTypeObject *type, PyObject *name)
         else
             BUMP_COUNTER(method_cache_misses);
 
-        Py_SETREF(method_cache[h].name, name);
+        Py_XSETREF(method_cache[h].name, name);
     } else {
         BUMP_COUNTER(method_cache_uncacheable);
     }
@@ -1088,6 +1088,17 @@ _PyEval_EvalFrameDefault(PyFrameObject *f, int throwflag)
 
 #define PYSHADOW_INIT_THRESHOLD 50
 
+/* Quickens a BINARY_ADD or INPLACE_ADD for exact int or float operands */
+#define QUICKEN_BINARY_ADD(left, right)                                       \
+    do {                                                                      \
+        if (PyLong_CheckExact(left) && PyLong_CheckExact(right)) {            \
+            _PyShadow_PatchByteCode(&shadow, next_instr, BINARY_ADD_INT, 0);  \
+        } else if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {   \
+            _PyShadow_PatchByteCode(                                          \
+                &shadow, next_instr, BINARY_ADD_FLOAT, 0);                    \
+        }                                                                     \
+    } while (0)
+
 /* Tuple access macros */
 
 #ifndef Py_DEBUG
@@ -1325,6 +1336,7 @@ _PyEval_EvalFrameDefault(PyFrameObject *f, int throwflag)
     PyObject ***global_cache = NULL;
     if (co->co_cache.shadow != NULL && PyDict_CheckExact(f->f_globals)) {
         shadow.shadow = co->co_cache.shadow;
+        shadow.shadow->used = 1;
         global_cache = shadow.shadow->globals;
         first_instr = &shadow.shadow->code[0];
     } else {
@@ -1765,6 +1777,9 @@ main_loop:
                 /* unicode_concatenate consumed the ref to left */
             }
             else {
+                if (shadow.shadow != NULL) {
+                    QUICKEN_BINARY_ADD(left, right);
+                }
                 sum = PyNumber_Add(left, right);
                 Py_DECREF(left);
             }
@@ -1978,6 +1993,9 @@ main_loop:
                 /* unicode_concatenate consumed the ref to left */
             }
             else {
+                if (shadow.shadow != NULL) {
+                    QUICKEN_BINARY_ADD(left, right);
+                }
                 sum = PyNumber_InPlaceAdd(left, right);
                 Py_DECREF(left);
             }
@@ -2066,6 +2084,11 @@ main_loop:
             PyObject *v = THIRD();
             int err;
             STACK_SHRINK(3);
+            if (shadow.shadow != NULL && PyList_CheckExact(container) &&
+                PyLong_CheckExact(sub)) {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, STORE_SUBSCR_LIST_INT, oparg);
+            }
             /* container[sub] = v */
             err = PyObject_SetItem(container, sub, v);
             Py_DECREF(v);
@@ -3212,6 +3235,11 @@ main_loop:
         case TARGET(COMPARE_OP): {
             PyObject *right = POP();
             PyObject *left = TOP();
+            if (shadow.shadow != NULL && oparg <= Py_GE &&
+                PyLong_CheckExact(left) && PyLong_CheckExact(right)) {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, COMPARE_OP_INT, oparg);
+            }
             PyObject *res = cmp_outcome(tstate, oparg, left, right);
             Py_DECREF(left);
             Py_DECREF(right);
@@ -3815,6 +3843,10 @@ main_loop:
             PyObject **sp, *res;
             sp = stack_pointer;
             int awaited = IS_AWAITED();
+            if (shadow.shadow != NULL && !awaited) {
+                _PyShadow_InitCallFunction(
+                    &shadow, next_instr, *(sp - oparg - 1), oparg);
+            }
             res = call_function(tstate,
                                 &sp,
                                 oparg,
@@ -5051,6 +5083,18 @@ main_loop:
             FAST_DISPATCH();
         }
 
+        case TARGET(LOAD_ATTR_MEGAMORPHIC): {
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *owner = TOP();
+            PyObject *res = _PyShadow_LoadAttrMegamorphic(
+                &shadow, next_instr, owner, name);
+            Py_DECREF(owner);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            DISPATCH();
+        }
+
         case TARGET(STORE_ATTR_UNCACHABLE): {
             PyObject *name = GETITEM(names, oparg);
             PyObject *owner = TOP();
@@ -5239,6 +5283,30 @@ main_loop:
             DISPATCH();
         }
 
+        case TARGET(LOAD_METHOD_MEGAMORPHIC): {
+            /* Designed to work in tandem with CALL_METHOD. */
+            PyObject *name = GETITEM(names, oparg);
+            PyObject *obj = TOP();
+            PyObject *meth = NULL;
+
+            int meth_found = _PyShadow_LoadMethodMegamorphic(
+                &shadow, next_instr, obj, name, &meth);
+
+            if (meth == NULL) {
+                goto error;
+            }
+
+            if (meth_found) {
+                SET_TOP(meth);
+                PUSH(obj); // self
+            } else {
+                SET_TOP(NULL);
+                Py_DECREF(obj);
+                PUSH(meth);
+            }
+            DISPATCH();
+        }
+
         case TARGET(BINARY_SUBSCR_TUPLE_CONST_INT): {
             PyObject *res;
             PyObject *container = TOP();
@@ -5341,6 +5409,176 @@ main_loop:
             FAST_DISPATCH();
         }
 
+        case TARGET(BINARY_SUBSCR_LIST_INT): {
+            PyObject *res;
+            PyObject *sub = POP();
+            PyObject *container = TOP();
+            if (PyList_CheckExact(container) && PyLong_CheckExact(sub)) {
+                res = _PyShadow_ListSubscrInt(container, sub);
+            } else {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, BINARY_SUBSCR, oparg);
+                res = PyObject_GetItem(container, sub);
+            }
+
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            FAST_DISPATCH();
+        }
+
+        case TARGET(STORE_SUBSCR_LIST_INT): {
+            PyObject *sub = TOP();
+            PyObject *container = SECOND();
+            PyObject *v = THIRD();
+            int err;
+            STACK_SHRINK(3);
+            if (PyList_CheckExact(container) && PyLong_CheckExact(sub)) {
+                err = _PyShadow_ListAssSubscrInt(container, sub, v);
+            } else {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, STORE_SUBSCR, oparg);
+                err = PyObject_SetItem(container, sub, v);
+            }
+            Py_DECREF(v);
+            Py_DECREF(container);
+            Py_DECREF(sub);
+            if (err != 0)
+                goto error;
+            FAST_DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_INT): {
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *sum;
+            if (PyLong_CheckExact(left) && PyLong_CheckExact(right)) {
+                sum = PyLong_Type.tp_as_number->nb_add(left, right);
+            } else {
+                sum = _PyShadow_BinaryAddMiss(&shadow, next_instr, left, right);
+            }
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            FAST_DISPATCH();
+        }
+
+        case TARGET(BINARY_ADD_FLOAT): {
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *sum;
+            if (PyFloat_CheckExact(left) && PyFloat_CheckExact(right)) {
+                sum = PyFloat_FromDouble(PyFloat_AS_DOUBLE(left) +
+                                         PyFloat_AS_DOUBLE(right));
+            } else {
+                sum = _PyShadow_BinaryAddMiss(&shadow, next_instr, left, right);
+            }
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(sum);
+            if (sum == NULL)
+                goto error;
+            FAST_DISPATCH();
+        }
+
+        case TARGET(COMPARE_OP_INT): {
+            PyObject *right = POP();
+            PyObject *left = TOP();
+            PyObject *res;
+            if (PyLong_CheckExact(left) && PyLong_CheckExact(right)) {
+                res = PyLong_Type.tp_richcompare(left, right, oparg);
+            } else {
+                _PyShadow_PatchByteCode(&shadow, next_instr, COMPARE_OP, oparg);
+                res = cmp_outcome(tstate, oparg, left, right);
+            }
+            Py_DECREF(left);
+            Py_DECREF(right);
+            SET_TOP(res);
+            if (res == NULL)
+                goto error;
+            PREDICT(POP_JUMP_IF_FALSE);
+            PREDICT(POP_JUMP_IF_TRUE);
+            DISPATCH();
+        }
+
+        case TARGET(CALL_FUNCTION_PYFUNC): {
+            PyObject **sp = stack_pointer;
+            PyObject *func = *(sp - oparg - 1);
+            PyObject *res;
+            if (_PyShadow_IsFastCallFunction(func, oparg)) {
+                res = _PyShadow_FastCallFunction(func, sp - oparg, oparg);
+                while (sp > stack_pointer - oparg - 1) {
+                    Py_DECREF(EXT_POP(sp));
+                }
+            } else {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, CALL_FUNCTION, oparg);
+                res = call_function(tstate, &sp, oparg, NULL, 0);
+            }
+            stack_pointer = sp;
+            PUSH(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
+        case TARGET(CALL_FUNCTION_CFUNC): {
+            PyObject **sp = stack_pointer;
+            PyObject *func = *(sp - oparg - 1);
+            PyObject *res;
+            if (_PyShadow_IsFastCallCFunction(func, oparg) &&
+                !tstate->use_tracing) {
+                res = _PyShadow_FastCallCFunction(
+                    tstate, func, sp - oparg, oparg);
+                while (sp > stack_pointer - oparg - 1) {
+                    Py_DECREF(EXT_POP(sp));
+                }
+            } else {
+                if (!_PyShadow_IsFastCallCFunction(func, oparg)) {
+                    _PyShadow_PatchByteCode(
+                        &shadow, next_instr, CALL_FUNCTION, oparg);
+                }
+                res = call_function(tstate, &sp, oparg, NULL, 0);
+            }
+            stack_pointer = sp;
+            PUSH(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
+        case TARGET(CALL_FUNCTION_TYPE): {
+            _PyShadow_TypeCallCache *cache =
+                _PyShadow_GetTypeCallCache(&shadow, oparg & 0xff);
+            int nargs = oparg >> 8;
+            PyObject **sp = stack_pointer;
+            PyObject *func = *(sp - nargs - 1);
+            PyObject *res;
+            if (func == (PyObject *)cache->type &&
+                cache->type->tp_version_tag == cache->version_tag) {
+                res = _PyShadow_CallType(cache, sp - nargs, nargs);
+                while (sp > stack_pointer - nargs - 1) {
+                    Py_DECREF(EXT_POP(sp));
+                }
+            } else {
+                _PyShadow_PatchByteCode(
+                    &shadow, next_instr, CALL_FUNCTION, nargs);
+                res = call_function(tstate, &sp, nargs, NULL, 0);
+            }
+            stack_pointer = sp;
+            PUSH(res);
+            if (res == NULL) {
+                goto error;
+            }
+            DISPATCH();
+        }
+
         case TARGET(BINARY_SUBSCR_DICT): {
             PyObject *res;
             PyObject *sub = POP();
@@ -47,6 +47,17 @@
      run and end up being the first to re-acquire it, making the "timeslices"
      much longer than expected.
      (Note: this mechanism is enabled with FORCE_SWITCHING above)
+
+   - Threads that have to wait for the GIL queue up in waiters_head/tail.
+     By default the queue is only bookkeeping and whichever waiter wakes up
+     first takes a free GIL. In FIFO mode (cinder knob "gilfifo") only the
+     oldest waiter may take it, and drop_gil() wakes every waiter so that
+     the oldest one is among them. This bounds how long a thread can be
+     starved by others repeatedly dropping and re-taking the GIL.
+
+   - When collect_stats is set (cinder knob "gilstats"), take_gil() and
+     drop_gil() record how long each thread waited for and held the GIL in
+     log2 histograms, which cinder.get_gil_stats() returns.
 */
 
 #include "condvar.h"
@@ -73,6 +84,9 @@
 #define COND_SIGNAL(cond) \
     if (PyCOND_SIGNAL(&(cond))) { \
         Py_FatalError("PyCOND_SIGNAL(" #cond ") failed"); };
+#define COND_BROADCAST(cond) \
+    if (PyCOND_BROADCAST(&(cond))) { \
+        Py_FatalError("PyCOND_BROADCAST(" #cond ") failed"); };
 #define COND_WAIT(cond, mut) \
     if (PyCOND_WAIT(&(cond), &(mut))) { \
         Py_FatalError("PyCOND_WAIT(" #cond ") failed"); };
@@ -113,6 +127,10 @@ static void create_gil(struct _gil_runtime_state *gil)
     COND_INIT(gil->switch_cond);
 #endif
     _Py_atomic_store_relaxed(&gil->last_holder, 0);
+    /* Waiters left over from before a fork don't exist in the child. */
+    gil->waiters_head = NULL;
+    gil->waiters_tail = NULL;
+    gil->acquired_at = 0;
     _Py_ANNOTATE_RWLOCK_CREATE(&gil->locked);
     _Py_atomic_store_explicit(&gil->locked, 0, _Py_memory_order_release);
 }
@@ -140,6 +158,51 @@ static void recreate_gil(struct _gil_runtime_state *gil)
     create_gil(gil);
 }
 
+static void
+gil_histogram_add(unsigned long long *histogram, _PyTime_t ns)
+{
+    unsigned long long us = ns > 0 ? (unsigned long long)ns / 1000 : 0;
+    int bucket = 0;
+    while (us != 0 && bucket < _Py_GIL_HISTOGRAM_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+static void
+gil_enqueue_waiter(struct _gil_runtime_state *gil,
+                   struct _gil_waiter *waiter)
+{
+    waiter->prev = gil->waiters_tail;
+    waiter->next = NULL;
+    if (gil->waiters_tail != NULL) {
+        gil->waiters_tail->next = waiter;
+    }
+    else {
+        gil->waiters_head = waiter;
+    }
+    gil->waiters_tail = waiter;
+}
+
+static void
+gil_dequeue_waiter(struct _gil_runtime_state *gil,
+                   struct _gil_waiter *waiter)
+{
+    if (waiter->prev != NULL) {
+        waiter->prev->next = waiter->next;
+    }
+    else {
+        gil->waiters_head = waiter->next;
+    }
+    if (waiter->next != NULL) {
+        waiter->next->prev = waiter->prev;
+    }
+    else {
+        gil->waiters_tail = waiter->prev;
+    }
+}
+
 void
 drop_gil(struct _ceval_runtime_state *ceval, PyThreadState *tstate)
 {
@@ -157,9 +220,26 @@ drop_gil(struct _ceval_runtime_state *ceval, PyThreadState *tstate)
     }
 
     MUTEX_LOCK(gil->mutex);
+    if (gil->collect_stats) {
+        if (gil->acquired_at != 0) {
+            gil_histogram_add(gil->stats.hold,
+                              _PyTime_GetMonotonicClock() - gil->acquired_at);
+        }
+        if (_Py_atomic_load_relaxed(&ceval->gil_drop_request)) {
+            gil->stats.forced_switches++;
+        }
+    }
+    gil->acquired_at = 0;
     _Py_ANNOTATE_RWLOCK_RELEASED(&gil->locked, /*is_write=*/1);
     _Py_atomic_store_relaxed(&gil->locked, 0);
-    COND_SIGNAL(gil->cond);
+    if (gil->fifo && gil->waiters_head != NULL) {
+        /* The condition variable may wake any waiter, but only the oldest
+           one can take the GIL. */
+        COND_BROADCAST(gil->cond);
+    }
+    else {
+        COND_SIGNAL(gil->cond);
+    }
     MUTEX_UNLOCK(gil->mutex);
 
 #ifdef FORCE_SWITCHING
@@ -189,13 +269,21 @@ take_gil(struct _ceval_runtime_state *ceval, PyThreadState *tstate)
 
     struct _gil_runtime_state *gil = &ceval->gil;
     int err = errno;
+    _PyTime_t wait_start = 0;
+    struct _gil_waiter waiter;
+    if (gil->collect_stats) {
+        wait_start = _PyTime_GetMonotonicClock();
+    }
     MUTEX_LOCK(gil->mutex);
 
-    if (!_Py_atomic_load_relaxed(&gil->locked)) {
+    if (!_Py_atomic_load_relaxed(&gil->locked) &&
+        (!gil->fifo || gil->waiters_head == NULL)) {
         goto _ready;
     }
 
-    while (_Py_atomic_load_relaxed(&gil->locked)) {
+    gil_enqueue_waiter(gil, &waiter);
+    while (_Py_atomic_load_relaxed(&gil->locked) ||
+           (gil->fifo && gil->waiters_head != &waiter)) {
         int timed_out = 0;
         unsigned long saved_switchnum;
 
@@ -211,9 +299,20 @@ take_gil(struct _ceval_runtime_state *ceval, PyThreadState *tstate)
             gil->switch_number == saved_switchnum)
         {
             SET_GIL_DROP_REQUEST(ceval);
+            if (gil->collect_stats) {
+                gil->stats.drop_requests++;
+            }
         }
     }
+    gil_dequeue_waiter(gil, &waiter);
 _ready:
+    if (gil->collect_stats) {
+        _PyTime_t now = _PyTime_GetMonotonicClock();
+        if (wait_start != 0) {
+            gil_histogram_add(gil->stats.wait, now - wait_start);
+        }
+        gil->acquired_at = now;
+    }
 #ifdef FORCE_SWITCHING
     /* This mutex must be taken before modifying gil->last_holder:
        see drop_gil(). */
@@ -252,3 +351,103 @@ unsigned long _PyEval_GetSwitchInterval()
 {
     return _PyRuntime.ceval.gil.interval;
 }
+
+void _PyEval_SetGILFifo(int enabled)
+{
+    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
+    if (!gil_created(gil)) {
+        gil->fifo = enabled;
+        return;
+    }
+    MUTEX_LOCK(gil->mutex);
+    gil->fifo = enabled;
+    /* Let waiters re-check whether they may take the GIL. */
+    COND_BROADCAST(gil->cond);
+    MUTEX_UNLOCK(gil->mutex);
+}
+
+int _PyEval_GetGILFifo(void)
+{
+    return _PyRuntime.ceval.gil.fifo;
+}
+
+void _PyEval_SetGILStatsEnabled(int enabled)
+{
+    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
+    if (!gil_created(gil)) {
+        gil->collect_stats = enabled;
+        return;
+    }
+    MUTEX_LOCK(gil->mutex);
+    gil->collect_stats = enabled;
+    MUTEX_UNLOCK(gil->mutex);
+}
+
+int _PyEval_GetGILStatsEnabled(void)
+{
+    return _PyRuntime.ceval.gil.collect_stats;
+}
+
+void _PyEval_ResetGILStats(void)
+{
+    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
+    if (!gil_created(gil)) {
+        memset(&gil->stats, 0, sizeof(gil->stats));
+        return;
+    }
+    MUTEX_LOCK(gil->mutex);
+    memset(&gil->stats, 0, sizeof(gil->stats));
+    MUTEX_UNLOCK(gil->mutex);
+}
+
+static PyObject *
+gil_histogram_to_list(const unsigned long long *histogram)
+{
+    PyObject *list = PyList_New(_Py_GIL_HISTOGRAM_BUCKETS);
+    if (list == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < _Py_GIL_HISTOGRAM_BUCKETS; i++) {
+        PyObject *count = PyLong_FromUnsignedLongLong(histogram[i]);
+        if (count == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, count);
+    }
+    return list;
+}
+
+PyObject *_PyEval_GetGILStats(void)
+{
+    struct _gil_runtime_state *gil = &_PyRuntime.ceval.gil;
+    struct _gil_stats stats;
+    unsigned long switches;
+    if (gil_created(gil)) {
+        MUTEX_LOCK(gil->mutex);
+        stats = gil->stats;
+        switches = gil->switch_number;
+        MUTEX_UNLOCK(gil->mutex);
+    }
+    else {
+        stats = gil->stats;
+        switches = gil->switch_number;
+    }
+
+    PyObject *wait = gil_histogram_to_list(stats.wait);
+    if (wait == NULL) {
+        return NULL;
+    }
+    PyObject *hold = gil_histogram_to_list(stats.hold);
+    if (hold == NULL) {
+        Py_DECREF(wait);
+        return NULL;
+    }
+    return Py_BuildValue(
+        "{sNsNsKsKsk}",
+        "wait", wait,
+        "hold", hold,
+        "drop_requests", stats.drop_requests,
+        "forced_switches", stats.forced_switches,
+        "switches", switches);
+}
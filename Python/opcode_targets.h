@@ -199,16 +199,16 @@ static void *opcode_targets[256] = {
     &&TARGET_RETURN_INT,
     &&TARGET_LOAD_METHOD_SUPER,
     &&TARGET_LOAD_ATTR_SUPER,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
-    &&_unknown_opcode,
+    &&TARGET_LOAD_ATTR_MEGAMORPHIC,
+    &&TARGET_LOAD_METHOD_MEGAMORPHIC,
+    &&TARGET_BINARY_ADD_INT,
+    &&TARGET_BINARY_ADD_FLOAT,
+    &&TARGET_COMPARE_OP_INT,
+    &&TARGET_BINARY_SUBSCR_LIST_INT,
+    &&TARGET_STORE_SUBSCR_LIST_INT,
+    &&TARGET_CALL_FUNCTION_PYFUNC,
+    &&TARGET_CALL_FUNCTION_CFUNC,
+    &&TARGET_CALL_FUNCTION_TYPE,
     &&_unknown_opcode,
     &&TARGET_LOAD_ATTR_S_MODULE,
     &&TARGET_LOAD_METHOD_S_MODULE,
@@ -39,11 +39,51 @@ PyTypeObject _PyCodeCache_RefType = {
     .tp_hash = (hashfunc)_Py_HashPointer,
 };
 
+int _PyShadow_CacheCompactionEnabled = 0;
+
+/* All live shadow code, see _PyShadow_CompactCaches */
+static _PyShadowCode *shadow_code_list = NULL;
+
+/* Bytes allocated to cache entries, by the kind of lookup they cache */
+enum {
+    CACHE_ENTRY_INSTANCE_ATTR,
+    CACHE_ENTRY_LOAD_METHOD,
+    CACHE_ENTRY_MODULE_ATTR,
+    CACHE_ENTRY_KINDS,
+};
+static Py_ssize_t cache_entry_bytes[CACHE_ENTRY_KINDS];
+
+_PyCacheType _PyShadow_BaseCache;
+
+static int
+cache_entry_kind(PyTypeObject *type)
+{
+    if (type == &_PyShadow_ModuleAttrEntryType.type ||
+        type == &_PyShadow_StrictModuleAttrEntryType.type) {
+        return CACHE_ENTRY_MODULE_ATTR;
+    } else if (type == &_PyShadow_InstanceCacheDictMethod.type ||
+               type == &_PyShadow_InstanceCacheNoDictMethod.type ||
+               type == &_PyShadow_InstanceCacheSplitDictMethod.type) {
+        return CACHE_ENTRY_LOAD_METHOD;
+    }
+    return CACHE_ENTRY_INSTANCE_ATTR;
+}
+
+static void
+cache_entry_free(PyObject *self)
+{
+    PyTypeObject *type = Py_TYPE(self);
+    if (type->tp_base == &_PyShadow_BaseCache.type) {
+        cache_entry_bytes[cache_entry_kind(type)] -= type->tp_basicsize;
+    }
+    type->tp_free(self);
+}
+
 static void
 instance_attr_free(PyObject *self)
 {
     Py_DECREF(((_PyShadow_InstanceAttrEntry *)self)->name);
-    Py_TYPE(self)->tp_free(self);
+    cache_entry_free(self);
 }
 
 /* Base type for our cache types.  Mainly exists for debugging purposes so
@@ -184,7 +224,7 @@ static void
 module_attr_free(PyObject *self)
 {
     Py_DECREF(((_PyShadow_ModuleAttrEntry *)self)->name);
-    Py_TYPE(self)->tp_free(self);
+    cache_entry_free(self);
 }
 
 int
@@ -595,6 +635,10 @@ _PyShadow_LoadAttrInvalidate(_PyShadow_EvalState *state,
 }
 
 PyObject *_PyShadow_GetCacheForAttr(PyCodeCacheRef *cache, PyObject *name);
+int _PyShadow_AttrMiss(_PyShadow_EvalState *shadow,
+                       const _Py_CODEUNIT *next_instr,
+                       PyObject *name,
+                       int opcode);
 PyObject *_PyShadow_LoadAttrRunCacheEntry(_PyShadow_EvalState *state,
                                           const _Py_CODEUNIT *next_instr,
                                           PyObject *entry,
@@ -653,6 +697,29 @@ _PyShadow_GetOriginalConst(_PyShadow_EvalState *state,
     return PyTuple_GET_ITEM(state->code->co_consts, oparg);
 }
 
+static PyObject *
+_PyShadow_LoadAttrSwitchMegamorphic(_PyShadow_EvalState *state,
+                                    const _Py_CODEUNIT *next_instr,
+                                    _PyShadow_InstanceAttrEntry **entries,
+                                    PyObject *owner,
+                                    PyObject *name)
+{
+    /* Free the polymorphic cache so another call site can reuse its slot */
+    for (Py_ssize_t i = 0; i < state->shadow->polymorphic_caches_size; i++) {
+        if (state->shadow->polymorphic_caches[i] == entries) {
+            state->shadow->polymorphic_caches[i] = NULL;
+            break;
+        }
+    }
+    for (int i = 0; i < POLYMORPHIC_CACHE_SIZE; i++) {
+        Py_XDECREF(entries[i]);
+    }
+    PyMem_Free(entries);
+
+    _PyShadow_AttrMiss(state, next_instr, name, LOAD_ATTR_MEGAMORPHIC);
+    return _PyShadow_LoadAttrMegamorphic(state, next_instr, owner, name);
+}
+
 PyObject *
 _PyShadow_LoadAttrPolymorphic(_PyShadow_EvalState *state,
                               const _Py_CODEUNIT *next_instr,
@@ -672,9 +739,13 @@ _PyShadow_LoadAttrPolymorphic(_PyShadow_EvalState *state,
 
     PyObject *name = _PyShadow_GetOriginalName(state, next_instr);
 
-    if (index == -1 || type->tp_getattro != PyObject_GenericGetAttr) {
+    if (type->tp_getattro != PyObject_GenericGetAttr) {
         /* This type cannot be cached in a polymorphic cache */
         goto done;
+    } else if (index == -1) {
+        /* We've seen more types than fit in the polymorphic cache */
+        return _PyShadow_LoadAttrSwitchMegamorphic(
+            state, next_instr, entries, owner, name);
     }
 
     PyCodeCacheRef *cache = _PyShadow_GetCache((PyObject *)type);
@@ -733,6 +804,156 @@ run_entry:
 /* Private API for the LOAD_METHOD opcode. */
 extern int _PyObject_GetMethod(PyObject *, PyObject *, PyObject **);
 
+/* Call sites which have seen more types than fit in a polymorphic cache share
+ * a single fixed-size cache keyed by the owner's type version tag and the
+ * attribute name.  Version tags are never reused and change whenever a type
+ * is modified, so an entry whose tag matches the owner's type was created for
+ * that type and is still valid for it. */
+typedef struct {
+    unsigned int version_tag;
+    PyObject *name;  /* strong reference */
+    PyObject *entry; /* strong reference, NULL if the attribute is uncachable */
+} _PyShadow_MegamorphicEntry;
+
+static _PyShadow_MegamorphicEntry megamorphic_cache[MEGAMORPHIC_CACHE_SIZE];
+
+#define MEGAMORPHIC_CACHE_HASH(version_tag, name)                             \
+    (((unsigned int)(version_tag) ^ (unsigned int)((uintptr_t)(name) >> 4)) & \
+     (MEGAMORPHIC_CACHE_SIZE - 1))
+
+/* Looks up the cache entry for name on type in the megamorphic cache,
+ * resolving and inserting it on a miss.  Returns -1 on error, otherwise sets
+ * *res to a new reference to the entry, or to NULL if the attribute can't be
+ * cached. */
+static int
+_PyShadow_MegamorphicLookup(_PyShadow_EvalState *state,
+                            const _Py_CODEUNIT *next_instr,
+                            PyTypeObject *type,
+                            PyObject *name,
+                            int opcode,
+                            PyObject **res)
+{
+    *res = NULL;
+    if (type->tp_getattro != PyObject_GenericGetAttr ||
+        (!PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) &&
+         !_PyType_AssignVersionTag(type))) {
+        INLINE_CACHE_RECORD_STAT(opcode, uncacheable);
+        return 0;
+    }
+
+    _PyShadow_MegamorphicEntry *slot =
+        &megamorphic_cache[MEGAMORPHIC_CACHE_HASH(type->tp_version_tag, name)];
+    if (slot->version_tag == type->tp_version_tag && slot->name == name &&
+        (slot->entry == NULL ||
+         ((_PyShadow_InstanceAttrEntry *)slot->entry)->type == type)) {
+        INLINE_CACHE_RECORD_STAT(opcode, hits);
+#ifdef INLINE_CACHE_PROFILE
+        _PyShadow_LogLocation(state, next_instr, "megamorphic_hit");
+#endif
+        Py_XINCREF(slot->entry);
+        *res = slot->entry;
+        return 0;
+    }
+
+    INLINE_CACHE_RECORD_STAT(opcode, misses);
+#ifdef INLINE_CACHE_PROFILE
+    _PyShadow_LogLocation(state, next_instr, "megamorphic_miss");
+#endif
+    PyCodeCacheRef *cache = _PyShadow_GetCache((PyObject *)type);
+    if (cache == NULL) {
+        return -1;
+    }
+
+    PyObject *entry = NULL;
+    if (cache->invalidate_count != CACHE_UPDATE_DISABLED) {
+        entry = _PyShadow_GetCacheForAttr(cache, name);
+        if (entry != NULL && _PyShadow_IsCacheValid(entry)) {
+            Py_INCREF(entry);
+        } else {
+            entry = _PyShadow_LoadCacheInfo(type, name, cache);
+            if (entry == NULL && PyErr_Occurred()) {
+                return -1;
+            }
+        }
+    }
+
+    /* Resolving the attribute may have modified the type */
+    if (PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
+        slot = &megamorphic_cache[MEGAMORPHIC_CACHE_HASH(
+            type->tp_version_tag, name)];
+        PyObject *old_name = slot->name;
+        PyObject *old_entry = slot->entry;
+        slot->version_tag = type->tp_version_tag;
+        Py_INCREF(name);
+        slot->name = name;
+        Py_XINCREF(entry);
+        slot->entry = entry;
+        Py_XDECREF(old_name);
+        Py_XDECREF(old_entry);
+    }
+    *res = entry;
+    return 0;
+}
+
+PyObject *
+_PyShadow_LoadAttrMegamorphic(_PyShadow_EvalState *state,
+                              const _Py_CODEUNIT *next_instr,
+                              PyObject *owner,
+                              PyObject *name)
+{
+    PyObject *entry;
+    if (_PyShadow_MegamorphicLookup(state,
+                                    next_instr,
+                                    Py_TYPE(owner),
+                                    name,
+                                    LOAD_ATTR_MEGAMORPHIC,
+                                    &entry) < 0) {
+        return NULL;
+    } else if (entry == NULL) {
+        return PyObject_GetAttr(owner, name);
+    }
+
+    PyObject *res =
+        _PyShadow_CacheType(entry)->load_func(state, next_instr, entry, owner);
+    Py_DECREF(entry);
+    return res;
+}
+
+int
+_PyShadow_LoadMethodMegamorphic(_PyShadow_EvalState *state,
+                                const _Py_CODEUNIT *next_instr,
+                                PyObject *obj,
+                                PyObject *name,
+                                PyObject **meth)
+{
+    PyObject *entry;
+    if (_PyShadow_MegamorphicLookup(state,
+                                    next_instr,
+                                    Py_TYPE(obj),
+                                    name,
+                                    LOAD_METHOD_MEGAMORPHIC,
+                                    &entry) < 0) {
+        return 0;
+    } else if (entry == NULL) {
+        return _PyObject_GetMethod(obj, name, meth);
+    }
+
+    int meth_found = _PyShadow_CacheType(entry)->load_method(
+        state, next_instr, (_PyShadow_InstanceAttrEntry *)entry, obj, meth);
+    Py_DECREF(entry);
+    return meth_found;
+}
+
+void
+_PyShadow_ClearMegamorphicCache(void)
+{
+    for (Py_ssize_t i = 0; i < MEGAMORPHIC_CACHE_SIZE; i++) {
+        megamorphic_cache[i].version_tag = 0;
+        Py_CLEAR(megamorphic_cache[i].name);
+        Py_CLEAR(megamorphic_cache[i].entry);
+    }
+}
+
 int
 _PyShadow_LoadMethodInvalidate(_PyShadow_EvalState *shadow,
                                const _Py_CODEUNIT *next_instr,
@@ -741,6 +962,17 @@ _PyShadow_LoadMethodInvalidate(_PyShadow_EvalState *shadow,
                                PyObject *type,
                                PyObject **meth)
 {
+    /* Type is coming from the cache entry.  If it is non-NULL then we're
+     * seeing a different type come through the call site, so rather than
+     * re-specializing it for each type switch over to the megamorphic cache */
+    if (type != NULL &&
+        Py_TYPE(owner)->tp_getattro == PyObject_GenericGetAttr &&
+        _PyShadow_PolymorphicCacheEnabled) {
+        _PyShadow_AttrMiss(shadow, next_instr, name, LOAD_METHOD_MEGAMORPHIC);
+        return _PyShadow_LoadMethodMegamorphic(
+            shadow, next_instr, owner, name, meth);
+    }
+
     if (_PyShadow_CacheHitInvalidate(
             shadow, next_instr, type, "invalidate_method")) {
         _PyShadow_LoadMethodMiss(shadow, next_instr, name);
@@ -959,6 +1191,117 @@ _PyShadow_CacheFieldType(_PyShadow_EvalState *state, int offset, int type)
     return cache_size;
 }
 
+static int
+_PyShadow_CacheTypeCall(_PyShadow_EvalState *state,
+                        PyTypeObject *type,
+                        PyObject *init)
+{
+    _PyShadow_TypeCallCache *caches = state->shadow->type_call_caches;
+    Py_ssize_t cache_size = state->shadow->type_call_caches_size;
+    for (Py_ssize_t i = 0; i < cache_size; i++) {
+        if (caches[i].type == type) {
+            caches[i].version_tag = type->tp_version_tag;
+            caches[i].init = init;
+            return i;
+        }
+    }
+    if (cache_size >= 256) {
+        return -1;
+    }
+
+    caches = PyMem_Realloc(caches,
+                           sizeof(_PyShadow_TypeCallCache) * (cache_size + 1));
+    if (caches == NULL) {
+        return -1;
+    }
+    caches[cache_size].type = type;
+    caches[cache_size].version_tag = type->tp_version_tag;
+    caches[cache_size].init = init;
+    state->shadow->type_call_caches = caches;
+    state->shadow->type_call_caches_size = cache_size + 1;
+    return cache_size;
+}
+
+void
+_PyShadow_InitCallFunction(_PyShadow_EvalState *state,
+                           const _Py_CODEUNIT *next_instr,
+                           PyObject *func,
+                           int nargs)
+{
+    _Py_IDENTIFIER(__init__);
+
+    if (_PyShadow_IsFastCallFunction(func, nargs)) {
+        _PyShadow_PatchByteCode(
+            state, next_instr, CALL_FUNCTION_PYFUNC, nargs);
+        return;
+    } else if (_PyShadow_IsFastCallCFunction(func, nargs)) {
+        _PyShadow_PatchByteCode(
+            state, next_instr, CALL_FUNCTION_CFUNC, nargs);
+        return;
+    } else if (!PyType_CheckExact(func) || nargs >= 0x80) {
+        return;
+    }
+
+    /* A type we can construct by allocating the instance and calling its
+     * __init__ directly, which is what type_call does when tp_new is
+     * object_new */
+    PyTypeObject *type = (PyTypeObject *)func;
+    if (!PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE) ||
+        PyType_HasFeature(type, Py_TPFLAGS_IS_ABSTRACT) ||
+        type->tp_new != PyBaseObject_Type.tp_new) {
+        return;
+    }
+    PyObject *init = _PyType_LookupId(type, &PyId___init__);
+    if (init == NULL || !PyFunction_Check(init) ||
+        !PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG)) {
+        return;
+    }
+
+    int offset = _PyShadow_CacheTypeCall(state, type, init);
+    if (offset != -1) {
+        _PyShadow_PatchByteCode(
+            state, next_instr, CALL_FUNCTION_TYPE, (nargs << 8) | offset);
+    }
+}
+
+PyObject *
+_PyShadow_CallType(_PyShadow_TypeCallCache *cache,
+                   PyObject **args,
+                   Py_ssize_t nargs)
+{
+    PyTypeObject *type = cache->type;
+    PyObject *init = cache->init;
+    PyObject *self = type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    /* The type sits right before the arguments on the value stack, swap the
+     * new instance in so __init__ can be called without copying them */
+    PyObject **stack = args - 1;
+    PyObject *callable = *stack;
+    *stack = self;
+    Py_INCREF(init);
+    PyObject *res = _PyObject_Vectorcall(init, stack, nargs + 1, NULL);
+    Py_DECREF(init);
+    *stack = callable;
+
+    if (res == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    if (res != Py_None) {
+        PyErr_Format(PyExc_TypeError,
+                     "__init__() should return None, not '%.200s'",
+                     Py_TYPE(res)->tp_name);
+        Py_DECREF(res);
+        Py_DECREF(self);
+        return NULL;
+    }
+    Py_DECREF(res);
+    return self;
+}
+
 typedef int (*attr_miss_invalidate_func)(_PyShadow_EvalState *state,
                                          const _Py_CODEUNIT *next_instr,
                                          PyObject *name);
@@ -1182,7 +1525,12 @@ static PyObject *
 _PyShadow_NewCacheEntry(_PyCacheType *cache_type)
 {
     INLINE_CACHE_ENTRY_CREATED(opcode, cache_type->tp_basicsize);
-    return cache_type->type.tp_alloc(&cache_type->type, 0);
+    PyObject *entry = cache_type->type.tp_alloc(&cache_type->type, 0);
+    if (entry != NULL) {
+        cache_entry_bytes[cache_entry_kind(&cache_type->type)] +=
+            cache_type->type.tp_basicsize;
+    }
+    return entry;
 }
 
 static _PyShadow_InstanceAttrEntry *
@@ -2063,8 +2411,13 @@ _PyShadow_BinarySubscrWithCache(_PyShadow_EvalState *shadow,
             res = _PyDict_GetItemMissing(container, sub);
         }
     } else if (PyList_CheckExact(container)) {
-        shadow_op = BINARY_SUBSCR_LIST;
-        res = _PyList_Subscript(container, sub);
+        if (PyLong_CheckExact(sub)) {
+            shadow_op = BINARY_SUBSCR_LIST_INT;
+            res = _PyShadow_ListSubscrInt(container, sub);
+        } else {
+            shadow_op = BINARY_SUBSCR_LIST;
+            res = _PyList_Subscript(container, sub);
+        }
     } else if (PyTuple_CheckExact(container)) {
         _Py_CODEUNIT prev_word = next_instr[-2];
         int prev_opcode = _Py_OPCODE(prev_word);
@@ -2095,6 +2448,24 @@ _PyShadow_BinarySubscrWithCache(_PyShadow_EvalState *shadow,
     return res;
 }
 
+PyObject *
+_PyShadow_BinaryAddMiss(_PyShadow_EvalState *shadow,
+                        const _Py_CODEUNIT *next_instr,
+                        PyObject *left,
+                        PyObject *right)
+{
+    _Py_CODEUNIT *rawcode =
+        (_Py_CODEUNIT *)PyBytes_AS_STRING(shadow->code->co_code);
+    int opcode = _Py_OPCODE(rawcode[next_instr - *shadow->first_instr - 1]);
+    assert(opcode == BINARY_ADD || opcode == INPLACE_ADD);
+
+    _PyShadow_PatchByteCode(shadow, next_instr, opcode, 0);
+    if (opcode == INPLACE_ADD) {
+        return PyNumber_InPlaceAdd(left, right);
+    }
+    return PyNumber_Add(left, right);
+}
+
 #ifdef INLINE_CACHE_PROFILE
 
 /* Indexed by opcode */
@@ -2312,6 +2683,22 @@ _PyShadow_GetInlineCacheStats(PyObject *self)
         goto err;
     }
 
+    st = _PyShadow_AddOpcodeCacheStatsDict(
+        opcode_stats,
+        "LOAD_ATTR_MEGAMORPHIC",
+        &opcode_cache_stats[LOAD_ATTR_MEGAMORPHIC]);
+    if (st == -1) {
+        goto err;
+    }
+
+    st = _PyShadow_AddOpcodeCacheStatsDict(
+        opcode_stats,
+        "LOAD_METHOD_MEGAMORPHIC",
+        &opcode_cache_stats[LOAD_METHOD_MEGAMORPHIC]);
+    if (st == -1) {
+        goto err;
+    }
+
     PyObject *uncachable = _PyShadow_MakeUncachableStats();
     if (uncachable == NULL) {
         goto err;
@@ -2474,9 +2861,21 @@ _PyShadow_InitCache(PyCodeObject *co)
     shadow->field_caches = NULL;
     shadow->field_cache_size = 0;
 
+    shadow->type_call_caches = NULL;
+    shadow->type_call_caches_size = 0;
+
     cache_init(&shadow->l1_cache);
     cache_init(&shadow->cast_cache);
 
+    shadow->owner = co;
+    shadow->used = 1;
+    shadow->prev = NULL;
+    shadow->next = shadow_code_list;
+    if (shadow_code_list != NULL) {
+        shadow_code_list->prev = shadow;
+    }
+    shadow_code_list = shadow;
+
     co->co_cache.shadow = shadow;
     return 0;
 }
@@ -2484,6 +2883,16 @@ _PyShadow_InitCache(PyCodeObject *co)
 void
 _PyShadowCode_Free(_PyShadowCode *shadow)
 {
+    if (shadow->prev != NULL) {
+        shadow->prev->next = shadow->next;
+    } else {
+        assert(shadow_code_list == shadow);
+        shadow_code_list = shadow->next;
+    }
+    if (shadow->next != NULL) {
+        shadow->next->prev = shadow->prev;
+    }
+
     if (shadow->globals_size) {
         PyMem_Free(shadow->globals);
     }
@@ -2495,7 +2904,7 @@ _PyShadowCode_Free(_PyShadowCode *shadow)
     if (shadow->polymorphic_caches_size) {
         for (Py_ssize_t i = 0; i < shadow->polymorphic_caches_size; i++) {
             if (shadow->polymorphic_caches[i] == NULL) {
-                break;
+                continue;
             }
             for (int j = 0; j < POLYMORPHIC_CACHE_SIZE; j++) {
                 Py_XDECREF(shadow->polymorphic_caches[i][j]);
@@ -2545,6 +2954,9 @@ _PyShadowCode_Free(_PyShadowCode *shadow)
     if (shadow->field_caches != NULL) {
         PyMem_Free(shadow->field_caches);
     }
+    if (shadow->type_call_caches != NULL) {
+        PyMem_Free(shadow->type_call_caches);
+    }
     PyMem_Free(shadow);
 }
 
@@ -2577,3 +2989,83 @@ _PyShadow_ClearCache(PyObject *obj)
         }
     }
 }
+
+static int
+set_stat(PyObject *stats, const char *name, Py_ssize_t value)
+{
+    PyObject *v = PyLong_FromSsize_t(value);
+    if (v == NULL) {
+        return -1;
+    }
+    int res = PyDict_SetItemString(stats, name, v);
+    Py_DECREF(v);
+    return res;
+}
+
+PyObject *
+_PyShadow_GetCacheMemoryStats(void)
+{
+    Py_ssize_t code = 0, global = 0, polymorphic = 0;
+    for (_PyShadowCode *shadow = shadow_code_list; shadow != NULL;
+         shadow = shadow->next) {
+        code += sizeof(_PyShadowCode) + shadow->len;
+        code += sizeof(PyObject *) *
+                (shadow->l1_cache.size + shadow->cast_cache.size);
+        code += sizeof(PyObject **) * shadow->functions_size;
+        code += sizeof(_FieldCache) * shadow->field_cache_size;
+        code += sizeof(_PyShadow_TypeCallCache) *
+                shadow->type_call_caches_size;
+        global += sizeof(PyObject **) * shadow->globals_size;
+        polymorphic += sizeof(_PyShadow_InstanceAttrEntry **) *
+                       shadow->polymorphic_caches_size;
+        for (Py_ssize_t i = 0; i < shadow->polymorphic_caches_size; i++) {
+            if (shadow->polymorphic_caches[i] != NULL) {
+                polymorphic += sizeof(_PyShadow_InstanceAttrEntry *) *
+                               POLYMORPHIC_CACHE_SIZE;
+            }
+        }
+    }
+
+    PyObject *stats = PyDict_New();
+    if (stats == NULL) {
+        return NULL;
+    }
+    if (set_stat(stats, "code", code) ||
+        set_stat(stats, "global", global) ||
+        set_stat(stats, "polymorphic", polymorphic) ||
+        set_stat(stats, "megamorphic", sizeof(megamorphic_cache)) ||
+        set_stat(stats,
+                 "instance_attr",
+                 cache_entry_bytes[CACHE_ENTRY_INSTANCE_ATTR]) ||
+        set_stat(stats,
+                 "load_method",
+                 cache_entry_bytes[CACHE_ENTRY_LOAD_METHOD]) ||
+        set_stat(stats,
+                 "module_attr",
+                 cache_entry_bytes[CACHE_ENTRY_MODULE_ATTR])) {
+        Py_DECREF(stats);
+        return NULL;
+    }
+    return stats;
+}
+
+Py_ssize_t
+_PyShadow_CompactCaches(void)
+{
+    Py_ssize_t freed = 0;
+    _PyShadowCode *shadow = shadow_code_list;
+    while (shadow != NULL) {
+        _PyShadowCode *next = shadow->next;
+        PyCodeObject *co = shadow->owner;
+        if (shadow->used || co->co_cache.curcalls != 0) {
+            shadow->used = 0;
+        } else {
+            /* The code has to warm up again before it gets new caches */
+            _PyShadow_ClearCache((PyObject *)co);
+            co->co_cache.ncalls = 0;
+            freed++;
+        }
+        shadow = next;
+    }
+    return freed;
+}
@@ -762,7 +762,18 @@ dump_frame(int fd, PyFrameObject *frame)
     PyCodeObject *code;
     int lineno;
 
-    code = frame->f_code;
+    if (JIT_IsTinyFrame(frame)) {
+        /* Materializing the frame would allocate, which isn't signal safe.
+           A tiny frame only knows its code object, so report the first line
+           of the function, like a materialized JIT frame does. */
+        code = ((TinyFrame *)frame)->code;
+        lineno = code != NULL ? code->co_firstlineno : -1;
+    }
+    else {
+        code = frame->f_code;
+        /* PyFrame_GetLineNumber() was introduced in Python 2.7.0 and 3.2.0 */
+        lineno = PyCode_Addr2Line(code, frame->f_lasti);
+    }
     PUTS(fd, "  File ");
     if (code != NULL && code->co_filename != NULL
         && PyUnicode_Check(code->co_filename))
@@ -774,8 +785,6 @@ dump_frame(int fd, PyFrameObject *frame)
         PUTS(fd, "???");
     }
 
-    /* PyFrame_GetLineNumber() was introduced in Python 2.7.0 and 3.2.0 */
-    lineno = PyCode_Addr2Line(code, frame->f_lasti);
     PUTS(fd, ", line ");
     if (lineno >= 0) {
         _Py_DumpDecimal(fd, (unsigned long)lineno);
@@ -818,10 +827,16 @@ dump_traceback(int fd, PyThreadState *tstate, int write_header)
             PUTS(fd, "  ...\n");
             break;
         }
+        if (JIT_IsTinyFrame(frame)) {
+            dump_frame(fd, frame);
+            frame = ((TinyFrame *)frame)->t.f_back;
+            depth++;
+            continue;
+        }
         if (!PyFrame_Check(frame))
             break;
         dump_frame(fd, frame);
-        frame = JIT_MaterializePrevFrame(frame);
+        frame = frame->f_back;
         depth++;
     }
 }
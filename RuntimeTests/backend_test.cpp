@@ -396,4 +396,196 @@ TEST_F(BackendTest, MoveSequenceOpt2Test) {
   ASSERT_EQ((*iter)->opcode(), Instruction::kAdd);
   ASSERT_EQ((*iter)->getInput(1)->type(), OperandBase::kStack);
 }
+
+TEST_F(BackendTest, PeepholeLeaTest) {
+  auto lirfunc = std::make_unique<Function>();
+  auto bb = lirfunc->allocateBasicBlock();
+
+  bb->allocateInstr(
+      Instruction::kAdd,
+      nullptr,
+      OutPhyReg(PhyLocation::RAX),
+      PhyReg(PhyLocation::RSI),
+      Imm(8));
+  bb->allocateInstr(
+      Instruction::kSub,
+      nullptr,
+      OutPhyReg(PhyLocation::RDX),
+      PhyReg(PhyLocation::RSI),
+      Imm(16));
+  bb->allocateInstr(
+      Instruction::kAdd,
+      nullptr,
+      OutPhyReg(PhyLocation::RCX),
+      PhyReg(PhyLocation::RSI),
+      PhyReg(PhyLocation::RSP));
+  // the flags set by this one are read by the branch
+  bb->allocateInstr(
+      Instruction::kSub,
+      nullptr,
+      OutPhyReg(PhyLocation::RDI),
+      PhyReg(PhyLocation::RSI),
+      Imm(1));
+  bb->allocateInstr(Instruction::kBranchNZ, nullptr, Lbl(bb));
+
+  Environ env;
+  PostRegAllocRewrite post_rewrite(lirfunc.get(), &env);
+  post_rewrite.run();
+
+  /*
+  BB %0
+        RAX:Object = Lea [RSI:Object + 0x8]:Object
+        RDX:Object = Lea [RSI:Object - 0x10]:Object
+        RCX:Object = Lea [RSP:Object + RSI:Object]:Object
+        RDI:Object = Sub RSI:Object, 1(0x1):Object
+                     BranchNZ BB%0
+  */
+  ASSERT_EQ(bb->getNumInstrs(), 5);
+  auto& instrs = bb->instructions();
+
+  auto iter = instrs.begin();
+
+  auto lea = (iter++)->get();
+  ASSERT_EQ(lea->opcode(), Instruction::kLea);
+  auto indirect = lea->getInput(0)->getMemoryIndirect();
+  ASSERT_EQ(indirect->getBaseRegOperand()->getPhyRegister(), PhyLocation::RSI);
+  ASSERT_EQ(indirect->getIndexRegOperand(), nullptr);
+  ASSERT_EQ(indirect->getOffset(), 8);
+
+  lea = (iter++)->get();
+  ASSERT_EQ(lea->opcode(), Instruction::kLea);
+  indirect = lea->getInput(0)->getMemoryIndirect();
+  ASSERT_EQ(indirect->getOffset(), -16);
+
+  lea = (iter++)->get();
+  ASSERT_EQ(lea->opcode(), Instruction::kLea);
+  indirect = lea->getInput(0)->getMemoryIndirect();
+  // RSP cannot be an index register
+  ASSERT_EQ(indirect->getBaseRegOperand()->getPhyRegister(), PhyLocation::RSP);
+  ASSERT_EQ(
+      indirect->getIndexRegOperand()->getPhyRegister(), PhyLocation::RSI);
+
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kSub);
+  ASSERT_EQ((*iter)->opcode(), Instruction::kBranchNZ);
+}
+
+TEST_F(BackendTest, PeepholeCompareTest) {
+  auto lirfunc = std::make_unique<Function>();
+  auto bb = lirfunc->allocateBasicBlock();
+
+  // overwritten by the next compare before being read
+  bb->allocateInstr(
+      Instruction::kCmp,
+      nullptr,
+      PhyReg(PhyLocation::RAX),
+      PhyReg(PhyLocation::RCX));
+  bb->allocateInstr(
+      Instruction::kAnd, nullptr, PhyReg(PhyLocation::RAX), Imm(0xff));
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutStk(-16), PhyReg(PhyLocation::RAX));
+  // And has already set the same flags
+  bb->allocateInstr(
+      Instruction::kTest,
+      nullptr,
+      PhyReg(PhyLocation::RAX),
+      PhyReg(PhyLocation::RAX));
+  bb->allocateInstr(Instruction::kBranchZ, nullptr, Lbl(bb));
+
+  auto bb2 = lirfunc->allocateBasicBlock();
+  bb2->allocateInstr(
+      Instruction::kSub, nullptr, PhyReg(PhyLocation::RAX), Imm(1));
+  // Sub does not set the flags read by BranchL the same way as Test
+  bb2->allocateInstr(
+      Instruction::kTest,
+      nullptr,
+      PhyReg(PhyLocation::RAX),
+      PhyReg(PhyLocation::RAX));
+  bb2->allocateInstr(Instruction::kBranchL, nullptr, Lbl(bb2));
+
+  Environ env;
+  PostRegAllocRewrite post_rewrite(lirfunc.get(), &env);
+  post_rewrite.run();
+
+  /*
+  BB %0
+                     And RAX:Object, 255(0xff):Object
+  [RBP - 16]:Object = Move RAX:Object
+                     BranchZ BB%0
+  BB %1
+                     Sub RAX:Object, 1(0x1):Object
+                     Test RAX:Object, RAX:Object
+                     BranchL BB%1
+  */
+  ASSERT_EQ(bb->getNumInstrs(), 3);
+  auto iter = bb->instructions().begin();
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kAnd);
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kMove);
+  ASSERT_EQ((*iter)->opcode(), Instruction::kBranchZ);
+
+  ASSERT_EQ(bb2->getNumInstrs(), 3);
+  iter = bb2->instructions().begin();
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kSub);
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kTest);
+  ASSERT_EQ((*iter)->opcode(), Instruction::kBranchL);
+}
+
+TEST_F(BackendTest, PeepholeStackSlotForwardingTest) {
+  auto lirfunc = std::make_unique<Function>();
+  auto bb = lirfunc->allocateBasicBlock();
+
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutStk(-16), PhyReg(PhyLocation::RAX));
+  bb->allocateInstr(
+      Instruction::kAdd,
+      nullptr,
+      PhyReg(PhyLocation::RCX),
+      PhyReg(PhyLocation::RDX));
+  // RAX still holds the value of [RBP - 16]
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutPhyReg(PhyLocation::RAX), Stk(-16));
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutPhyReg(PhyLocation::RSI), Stk(-16));
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutStk(-16), PhyReg(PhyLocation::RAX));
+  // RAX and RSI no longer hold the value of [RBP - 16]
+  bb->allocateInstr(
+      Instruction::kAdd, nullptr, PhyReg(PhyLocation::RAX), Imm(1));
+  bb->allocateInstr(
+      Instruction::kMove,
+      nullptr,
+      OutPhyReg(PhyLocation::RSI),
+      PhyReg(PhyLocation::RDX));
+  bb->allocateInstr(
+      Instruction::kMove, nullptr, OutPhyReg(PhyLocation::RDI), Stk(-16));
+
+  Environ env;
+  PostRegAllocRewrite post_rewrite(lirfunc.get(), &env);
+  post_rewrite.run();
+
+  /*
+  BB %0
+  [RBP - 16]:Object = Move RAX:Object
+                     Add RCX:Object, RDX:Object
+        RSI:Object = Move RAX:Object
+                     Add RAX:Object, 1(0x1):Object
+        RSI:Object = Move RDX:Object
+        RDI:Object = Move [RBP - 16]:Object
+  */
+  ASSERT_EQ(bb->getNumInstrs(), 6);
+  auto iter = bb->instructions().begin();
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kMove);
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kAdd);
+
+  auto move = (iter++)->get();
+  ASSERT_EQ(move->opcode(), Instruction::kMove);
+  ASSERT_EQ(move->output()->getPhyRegister(), PhyLocation::RSI);
+  ASSERT_EQ(move->getInput(0)->getPhyRegister(), PhyLocation::RAX);
+
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kAdd);
+  ASSERT_EQ((*(iter++))->opcode(), Instruction::kMove);
+
+  move = iter->get();
+  ASSERT_EQ(move->output()->getPhyRegister(), PhyLocation::RDI);
+  ASSERT_EQ(move->getInput(0)->type(), OperandBase::kStack);
+}
 } // namespace jit::codegen
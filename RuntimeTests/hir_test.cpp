@@ -437,3 +437,78 @@ TEST_F(EdgeCaseTest, IgnoreUnreachableLoops) {
 )";
   EXPECT_EQ(HIRPrinter(true).ToString(*(irfunc)), expected);
 }
+
+TEST_F(EdgeCaseTest, CountedEvalBreakerCheck) {
+  const char* src = R"(
+def test(x):
+  while x:
+    x = x - 1
+)";
+  std::unique_ptr<Function> irfunc;
+  long saved_interval = g_eval_breaker_check_interval;
+  g_eval_breaker_check_interval = 8;
+  CompileToHIR(src, "test", irfunc);
+  g_eval_breaker_check_interval = saved_interval;
+  ASSERT_NE(irfunc.get(), nullptr);
+
+  const char* expected = R"(fun jittestmodule:test {
+  bb 3 {
+    v0 = LoadArg<0; "x">
+    v1 = LoadConst<CInt64[8]>
+    Branch<4>
+  }
+
+  bb 4 (preds 1, 3) {
+    v6 = LoadConst<CInt64[1]>
+    v1 = IntBinaryOp<Subtract> v1 v6
+    CondBranch<0, 5> v1
+  }
+
+  bb 5 (preds 4) {
+    v1 = LoadConst<CInt64[8]>
+    v7 = LoadEvalBreaker
+    CondBranch<6, 0> v7
+  }
+
+  bb 6 (preds 5) {
+    v8 = RunPeriodicTasks {
+      NextInstrOffset 0
+      Locals<1> v0
+    }
+    Branch<0>
+  }
+
+  bb 0 (preds 4, 5, 6) {
+    v0 = CheckVar<0; "x"> v0 {
+      NextInstrOffset 2
+      Locals<1> v0
+    }
+    v2 = IsTruthy v0 {
+      NextInstrOffset 4
+      Locals<1> v0
+    }
+    CondBranch<1, 2> v2
+  }
+
+  bb 1 (preds 0) {
+    v0 = CheckVar<0; "x"> v0 {
+      NextInstrOffset 6
+      Locals<1> v0
+    }
+    v3 = LoadConst<LongExact[1]>
+    v4 = BinaryOp<Subtract> v0 v3 {
+      NextInstrOffset 10
+      Locals<1> v0
+    }
+    v0 = Assign v4
+    Branch<4>
+  }
+
+  bb 2 (preds 0) {
+    v5 = LoadConst<NoneType>
+    Return v5
+  }
+}
+)";
+  EXPECT_EQ(HIRPrinter().ToString(*(irfunc)), expected);
+}
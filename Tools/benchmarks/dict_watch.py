@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+"""Microbenchmark for the JIT's dict watchers: the cost of writing to a watched
+module dict, and the memory used per watched key.
+
+Run with -X jit."""
+
+import cinderjit
+
+
+NUM_KEYS = 2000
+KEYS_PER_FUNC = 100
+
+
+def make_module(num_keys):
+    """Build a module-like namespace with num_keys globals, each of which is
+    read by a JIT-compiled function, so every key has a global cache watching
+    it."""
+    ns = {f"g{i}": i for i in range(num_keys)}
+    for start in range(0, num_keys, KEYS_PER_FUNC):
+        names = [f"g{i}" for i in range(start, min(start + KEYS_PER_FUNC, num_keys))]
+        src = f"def read_{start}():\n    return " + " + ".join(names) + "\n"
+        exec(src, ns)
+        func = ns[f"read_{start}"]
+        cinderjit.force_compile(func)
+        func()
+    return ns
+
+
+WATCHED_KEYS = [f"g{i}" for i in range(NUM_KEYS)]
+UNWATCHED_KEYS = [f"u{i}" for i in range(NUM_KEYS)]
+
+
+def bench_notify(ns):
+    # Every store to a watched key notifies the caches watching it.
+    for key in WATCHED_KEYS:
+        ns[key] = 0
+
+
+def bench_notify_unwatched_key(ns):
+    # Stores to keys nobody watches still go through the watcher lookup.
+    for key in UNWATCHED_KEYS:
+        ns[key] = 0
+
+
+def run():
+    ns = make_module(NUM_KEYS)
+    bench_notify(ns)
+    bench_notify_unwatched_key(ns)
+
+
+if __name__ == "__main__":
+    import sys
+    import time
+
+    num_iterations = 100
+    if len(sys.argv) > 1:
+        num_iterations = int(sys.argv[1])
+
+    before = cinderjit.get_dict_watch_stats()
+    ns = make_module(NUM_KEYS)
+    after = cinderjit.get_dict_watch_stats()
+    keys = after["keys"] - before["keys"]
+    print(
+        f"watched keys: {keys}, "
+        f"{(after['bytes'] - before['bytes']) / keys:.1f} bytes per key"
+    )
+
+    for bench in (bench_notify, bench_notify_unwatched_key):
+        start = time.perf_counter()
+        for _ in range(num_iterations):
+            bench(ns)
+        elapsed = time.perf_counter() - start
+        print(
+            f"{bench.__name__}: "
+            f"{elapsed * 1e9 / (NUM_KEYS * num_iterations):.1f} ns per store"
+        )
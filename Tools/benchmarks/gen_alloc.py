@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+"""Microbenchmark for creating and tearing down short-lived generators and
+coroutines."""
+
+
+def small_gen(n):
+    yield n
+
+
+# A generator with enough values live across its first yield to need more
+# than the minimum amount of JIT generator spill space.
+_LARGE_GEN_VALUES = 128
+exec(
+    "def large_gen(n):\n"
+    + "".join(f"    v{i} = n + {i}\n" for i in range(_LARGE_GEN_VALUES))
+    + "    yield n\n"
+    + "    yield "
+    + " + ".join(f"v{i}" for i in range(_LARGE_GEN_VALUES))
+    + "\n"
+)
+
+
+async def leaf_coro(n):
+    return n
+
+
+async def parent_coro(n):
+    return await leaf_coro(n) + 1
+
+
+def bench_generators(count):
+    total = 0
+    for i in range(count):
+        for x in small_gen(i):
+            total += x
+    return total
+
+
+def bench_unfinished_generators(count):
+    # Generators dropped before running to completion.
+    total = 0
+    for i in range(count):
+        total += next(large_gen(i))
+    return total
+
+
+def bench_coroutines(count):
+    total = 0
+    for i in range(count):
+        coro = parent_coro(i)
+        try:
+            coro.send(None)
+        except StopIteration as e:
+            total += e.value
+    return total
+
+
+def run(count=100000):
+    bench_generators(count)
+    bench_unfinished_generators(count)
+    bench_coroutines(count)
+
+
+if __name__ == "__main__":
+    import sys
+    import time
+
+    num_iterations = 1
+    if len(sys.argv) > 1:
+        num_iterations = int(sys.argv[1])
+
+    count = 100000
+    for bench in (bench_generators, bench_unfinished_generators, bench_coroutines):
+        start = time.perf_counter()
+        for _ in range(num_iterations):
+            bench(count)
+        elapsed = time.perf_counter() - start
+        print(
+            f"{bench.__name__}: "
+            f"{elapsed * 1e9 / (count * num_iterations):.1f} ns per object"
+        )